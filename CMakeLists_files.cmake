@@ -41,6 +41,10 @@ list (APPEND MAIN_SOURCE_FILES
   opm/simulators/timestepping/AdaptiveSimulatorTimer.cpp
   opm/simulators/timestepping/SimulatorTimer.cpp
   opm/simulators/timestepping/gatherConvergenceReport.cpp
+  opm/simulators/timestepping/NewtonEarlyAbort.cpp
+  opm/simulators/utils/allReduceSumMax.cpp
+  opm/simulators/utils/BinaryCheckpoint.cpp
+  opm/simulators/utils/RestartSegments.cpp
   opm/simulators/utils/DeferredLogger.cpp
   opm/simulators/utils/gatherDeferredLogger.cpp
   opm/simulators/utils/moduleVersion.cpp
@@ -75,6 +79,11 @@ list (APPEND TEST_SOURCE_FILES
   tests/test_relpermdiagnostics.cpp
   tests/test_norne_pvt.cpp
   tests/test_wellstatefullyimplicitblackoil.cpp
+  tests/test_binarycheckpoint.cpp
+  tests/test_restartsegments.cpp
+  tests/test_recyclestorage.cc
+  tests/test_newtonearlyabort.cpp
+  tests/test_adaptiveimplicitsystem.cpp
   )
 
 if(MPI_FOUND)
@@ -101,6 +110,7 @@ list (APPEND TEST_DATA_FILES
   tests/deadfluids.DATA
   tests/equil_livegas.DATA
   tests/equil_liveoil.DATA
+  tests/drsdt.DATA
   tests/equil_rsvd_and_rvvd.DATA
   tests/wetgas.DATA
   tests/satfuncEPS_B.DATA
@@ -149,6 +159,7 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/simulators/aquifers/AquiferFetkovich.hpp
   opm/simulators/aquifers/BlackoilAquiferModel.hpp
   opm/simulators/aquifers/BlackoilAquiferModel_impl.hpp
+  opm/simulators/linalg/AdaptiveImplicitSystem.hpp
   opm/simulators/linalg/BlackoilAmg.hpp
   opm/simulators/linalg/BlackoilAmgCpr.hpp
   opm/simulators/linalg/amgcpr.hh
@@ -182,10 +193,14 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/simulators/timestepping/SimulatorTimer.hpp
   opm/simulators/timestepping/SimulatorTimerInterface.hpp
   opm/simulators/timestepping/gatherConvergenceReport.hpp
+  opm/simulators/timestepping/NewtonEarlyAbort.hpp
   opm/simulators/utils/ParallelFileMerger.hpp
+  opm/simulators/utils/BinaryCheckpoint.hpp
+  opm/simulators/utils/RestartSegments.hpp
   opm/simulators/utils/DeferredLoggingErrorHelpers.hpp
   opm/simulators/utils/DeferredLogger.hpp
   opm/simulators/utils/gatherDeferredLogger.hpp
+  opm/simulators/utils/allReduceSumMax.hpp
   opm/simulators/utils/moduleVersion.hpp
   opm/simulators/wells/RateConverter.hpp
   opm/simulators/wells/SimFIBODetails.hpp
@@ -133,6 +133,14 @@ public:
     void deserialize(Restarter& res OPM_UNUSED)
     { }
 
+    /*!
+     * \brief Write the internal state of the aquifer model to a binary checkpoint or
+     *        read it from one.
+     */
+    template <class Serializer>
+    void checkpoint(Serializer& serializer OPM_UNUSED)
+    { }
+
 protected:
     Simulator& simulator_;
 };
@@ -228,17 +228,17 @@ protected:
         exteriorDofIdx_ = scvf.exteriorIndex();
         assert(interiorDofIdx_ != exteriorDofIdx_);
 
-        unsigned I = stencil.globalSpaceIndex(interiorDofIdx_);
-        unsigned J = stencil.globalSpaceIndex(exteriorDofIdx_);
-
-        Scalar trans = problem.transmissibility(elemCtx, interiorDofIdx_, exteriorDofIdx_);
+        // the quantities of the face which do not depend on the solution are
+        // precomputed by the problem, so they can be retrieved by a single lookup.
+        const auto& faceData = problem.faceData(elemCtx, interiorDofIdx_, exteriorDofIdx_);
+        Scalar trans = faceData.transmissibility;
         Scalar faceArea = scvf.area();
-        Scalar thpres = problem.thresholdPressure(I, J);
+        Scalar thpres = faceData.thresholdPressure;
 
         // estimate the gravity correction: for performance reasons we use a simplified
         // approach for this flux module that assumes that gravity is constant and always
         // acts into the downwards direction. (i.e., no centrifuge experiments, sorry.)
-        Scalar g = elemCtx.problem().gravity()[dimWorld - 1];
+        Scalar g = problem.gravity()[dimWorld - 1];
 
         const auto& intQuantsIn = elemCtx.intensiveQuantities(interiorDofIdx_, timeIdx);
         const auto& intQuantsEx = elemCtx.intensiveQuantities(exteriorDofIdx_, timeIdx);
@@ -248,12 +248,10 @@ protected:
         // solution would be to take the Z coordinate of the element centroids, but since
         // ECL seems to like to be inconsistent on that front, it needs to be done like
         // here...
-        Scalar zIn = problem.dofCenterDepth(elemCtx, interiorDofIdx_, timeIdx);
-        Scalar zEx = problem.dofCenterDepth(elemCtx, exteriorDofIdx_, timeIdx);
-
+        //
         // the distances from the DOF's depths. (i.e., the additional depth of the
         // exterior DOF)
-        Scalar distZ = zIn - zEx;
+        Scalar distZ = faceData.distZ;
 
         for (unsigned phaseIdx=0; phaseIdx < numPhases; phaseIdx++) {
             if (!FluidSystem::phaseIsActive(phaseIdx))
@@ -297,30 +295,16 @@ protected:
             }
             else {
                 // if the pressure difference is zero, we chose the DOF which has the
-                // larger volume associated to it as upstream DOF
-                Scalar Vin = elemCtx.dofVolume(interiorDofIdx_, /*timeIdx=*/0);
-                Scalar Vex = elemCtx.dofVolume(exteriorDofIdx_, /*timeIdx=*/0);
-                if (Vin > Vex) {
+                // larger volume associated to it as upstream DOF. if the volumes are
+                // also equal, we pick the DOF which exhibits the smaller global index.
+                if (faceData.centerIsUpstreamOnTie) {
                     upIdx_[phaseIdx] = interiorDofIdx_;
                     dnIdx_[phaseIdx] = exteriorDofIdx_;
                 }
-                else if (Vin < Vex) {
+                else {
                     upIdx_[phaseIdx] = exteriorDofIdx_;
                     dnIdx_[phaseIdx] = interiorDofIdx_;
                 }
-                else {
-                    assert(Vin == Vex);
-                    // if the volumes are also equal, we pick the DOF which exhibits the
-                    // smaller global index
-                    if (I < J) {
-                        upIdx_[phaseIdx] = interiorDofIdx_;
-                        dnIdx_[phaseIdx] = exteriorDofIdx_;
-                    }
-                    else {
-                        upIdx_[phaseIdx] = exteriorDofIdx_;
-                        dnIdx_[phaseIdx] = interiorDofIdx_;
-                    }
-                }
             }
 
             // apply the threshold pressure for the intersection. note that the concept
@@ -385,7 +369,7 @@ protected:
         // estimate the gravity correction: for performance reasons we use a simplified
         // approach for this flux module that assumes that gravity is constant and always
         // acts into the downwards direction. (i.e., no centrifuge experiments, sorry.)
-        Scalar g = elemCtx.problem().gravity()[dimWorld - 1];
+        Scalar g = problem.gravity()[dimWorld - 1];
 
         const auto& intQuantsIn = elemCtx.intensiveQuantities(interiorDofIdx_, timeIdx);
 
@@ -32,6 +32,10 @@
 #include <ewoms/common/signum.hh>
 
 #include <opm/material/common/Unused.hpp>
+#include <opm/simulators/utils/allReduceSumMax.hpp>
+
+#include <algorithm>
+#include <vector>
 
 BEGIN_PROPERTIES
 
@@ -64,6 +68,7 @@ class EclNewtonMethod : public BlackOilNewtonMethod<TypeTag>
     typedef typename GET_PROP_TYPE(TypeTag, Scalar) Scalar;
     typedef typename GET_PROP_TYPE(TypeTag, Linearizer) Linearizer;
     typedef typename GET_PROP_TYPE(TypeTag, ElementContext) ElementContext;
+    typedef typename GET_PROP_TYPE(TypeTag, ThreadManager) ThreadManager;
 
     static const unsigned numEq = GET_PROP_VALUE(TypeTag, NumEq);
 
@@ -136,16 +141,21 @@ public:
         Scalar newtonMaxError = EWOMS_GET_PARAM(TypeTag, Scalar, NewtonMaxError);
 
         // calculate the error as the maximum weighted tolerance of
-        // the solution's residual
-        this->error_ = 0.0;
-        Dune::FieldVector<Scalar, numEq> componentSumError;
-        std::fill(componentSumError.begin(), componentSumError.end(), 0.0);
-        Scalar sumPv = 0.0;
-        errorPvFraction_ = 0.0;
+        // the solution's residual. the degrees of freedom are distributed over the
+        // threads, each of which accumulates its own partial results.
+        const unsigned numThreads = ThreadManager::maxThreads();
+        std::vector<Scalar> threadError(numThreads, 0.0);
+        std::vector<Dune::FieldVector<Scalar, numEq> > threadComponentSumError(numThreads, Dune::FieldVector<Scalar, numEq>(0.0));
+        std::vector<Scalar> threadSumPv(numThreads, 0.0);
+        std::vector<Scalar> threadErrorPvFraction(numThreads, 0.0);
         const Scalar dt = this->simulator_.timeStepSize();
-        for (unsigned dofIdx = 0; dofIdx < currentResidual.size(); ++dofIdx) {
+        const int numDof = currentResidual.size();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int dofIdx = 0; dofIdx < numDof; ++dofIdx) {
             // do not consider auxiliary DOFs for the error
-            if (dofIdx >= this->model().numGridDof()
+            if (static_cast<unsigned>(dofIdx) >= this->model().numGridDof()
                 || this->model().dofTotalVolume(dofIdx) <= 0.0)
                 continue;
 
@@ -158,11 +168,12 @@ public:
                     continue;
             }
 
+            const unsigned threadId = ThreadManager::threadId();
             const auto& r = currentResidual[dofIdx];
             Scalar pvValue =
                 this->simulator_.problem().referencePorosity(dofIdx, /*timeIdx=*/0)
                 * this->model().dofTotalVolume(dofIdx);
-            sumPv += pvValue;
+            threadSumPv[threadId] += pvValue;
             bool cnvViolated = false;
 
             Scalar dofVolume = this->model().dofTotalVolume(dofIdx);
@@ -178,22 +189,45 @@ public:
                     tmpError2 *= dofVolume;
                 }
 
-                this->error_ = Opm::max(std::abs(tmpError), this->error_);
+                threadError[threadId] = Opm::max(std::abs(tmpError), threadError[threadId]);
 
                 if (std::abs(tmpError) > this->tolerance_)
                     cnvViolated = true;
 
-                componentSumError[eqIdx] += std::abs(tmpError2);
+                threadComponentSumError[threadId][eqIdx] += std::abs(tmpError2);
             }
             if (cnvViolated)
-                errorPvFraction_ += pvValue;
+                threadErrorPvFraction[threadId] += pvValue;
         }
 
-        // take the other processes into account
-        this->error_ = this->comm_.max(this->error_);
-        componentSumError = this->comm_.sum(componentSumError);
-        sumPv = this->comm_.sum(sumPv);
-        errorPvFraction_ = this->comm_.sum(errorPvFraction_);
+        // combine the partial results of the threads in a fixed order
+        this->error_ = 0.0;
+        Dune::FieldVector<Scalar, numEq> componentSumError(0.0);
+        Scalar sumPv = 0.0;
+        errorPvFraction_ = 0.0;
+        for (unsigned threadId = 0; threadId < numThreads; ++threadId) {
+            this->error_ = Opm::max(threadError[threadId], this->error_);
+            componentSumError += threadComponentSumError[threadId];
+            sumPv += threadSumPv[threadId];
+            errorPvFraction_ += threadErrorPvFraction[threadId];
+        }
+
+        // take the other processes into account. all sums and the maximum error are
+        // reduced by a single collective operation
+        if (this->comm_.size() > 1) {
+            std::vector<double> buffer(componentSumError.begin(), componentSumError.end());
+            buffer.push_back(sumPv);
+            buffer.push_back(errorPvFraction_);
+            const int numSum = buffer.size();
+            buffer.push_back(this->error_);
+
+            Opm::allReduceSumMax(this->comm_, buffer, numSum);
+
+            std::copy(buffer.begin(), buffer.begin() + numEq, componentSumError.begin());
+            sumPv = buffer[numEq];
+            errorPvFraction_ = buffer[numEq + 1];
+            this->error_ = buffer[numSum];
+        }
 
         componentSumError /= sumPv;
         componentSumError *= dt;
@@ -44,6 +44,8 @@
 
 #include <dune/common/fvector.hh>
 
+#include <algorithm>
+#include <limits>
 #include <type_traits>
 
 BEGIN_PROPERTIES
@@ -78,6 +80,7 @@ class EclOutputBlackOilModule
     typedef typename GET_PROP_TYPE(TypeTag, Scalar) Scalar;
     typedef typename GET_PROP_TYPE(TypeTag, Evaluation) Evaluation;
     typedef typename GET_PROP_TYPE(TypeTag, ElementContext) ElementContext;
+    typedef typename GET_PROP_TYPE(TypeTag, IntensiveQuantities) IntensiveQuantities;
     typedef typename GET_PROP_TYPE(TypeTag, MaterialLaw) MaterialLaw;
     typedef typename GET_PROP_TYPE(TypeTag, MaterialLawParams) MaterialLawParams;
     typedef typename GET_PROP_TYPE(TypeTag, FluidSystem) FluidSystem;
@@ -111,10 +114,44 @@ class EclOutputBlackOilModule
         static const int numFipValues = PoreVolume + 1 ;
     };
 
+    // the quantities which are requested for individual cells by block keywords of
+    // the summary and by the RFT output
+    struct CellQuantity
+    {
+        enum CellQuantityId
+        {
+            WaterSaturation = 0, // BWSAT
+            GasSaturation = 1, // BGSAT
+            OilSaturation = 2, // BOSAT
+            Pressure = 3, // BPR
+            WaterRelPerm = 4, // BWKR, BKRW
+            GasRelPerm = 5, // BGKR, BKRG
+            OilRelPerm = 6, // BOKR, BKRO
+            WaterCapPressure = 7, // BWPC
+            GasCapPressure = 8, // BGPC
+            WaterViscosity = 9, // BVWAT, BWVIS
+            GasViscosity = 10, // BVGAS, BGVIS
+            OilViscosity = 11, // BVOIL, BOVIS
+            RftPressure = 12,
+            RftWaterSaturation = 13,
+            RftGasSaturation = 14,
+            Unhandled = 15
+        };
+    };
+
+    struct CellRequest
+    {
+        typename CellQuantity::CellQuantityId quantity;
+        double* value;
+    };
+
 public:
     template<class CollectDataToIORankType>
     EclOutputBlackOilModule(const Simulator& simulator, const CollectDataToIORankType& collectToIORank)
         : simulator_(simulator)
+        , allocBufferSize_(0)
+        , allocReportStepNum_(std::numeric_limits<unsigned>::max())
+        , allocSubstep_(false)
     {
         createLocalFipnum_();
 
@@ -131,6 +168,21 @@ public:
             }
         }
 
+        for (auto& val: blockData_) {
+            const auto quantity = blockQuantity_(val.first.first);
+            if (quantity == CellQuantity::Unhandled) {
+                std::string logstring = "Keyword '";
+                logstring.append(val.first.first);
+                logstring.append("' is unhandled for output to file.");
+                Opm::OpmLog::warning("Unhandled output keyword", logstring);
+                continue;
+            }
+
+            CellRequest request = { quantity, &val.second };
+            blockRequests_.emplace_back(val.first.second - 1, request);
+        }
+        compileCellRequests_();
+
         forceDisableFipOutput_ = EWOMS_GET_PARAM(TypeTag, bool, ForceDisableFluidInPlaceOutput);
     }
 
@@ -146,14 +198,25 @@ public:
     /*!
      * \brief Allocate memory for the scalar fields we would like to
      *        write to ECL output files
+     *
+     * The buffers keep their memory between report steps, i.e., they are only
+     * reallocated if the number of elements or the set of requested quantities
+     * changes.
      */
     void allocBuffers(unsigned bufferSize, unsigned reportStepNum, const bool substep, const bool log)
     {
         if (!std::is_same<Discretization, Ewoms::EcfvDiscretization<TypeTag> >::value)
             return;
 
+        // nothing to do if the buffers have already been set up for this step
+        if (bufferSize == allocBufferSize_ && reportStepNum == allocReportStepNum_ && substep == allocSubstep_)
+            return;
+        allocBufferSize_ = bufferSize;
+        allocReportStepNum_ = reportStepNum;
+        allocSubstep_ = substep;
+
         // Summary output is for all steps
-        const Opm::SummaryConfig summaryConfig = simulator_.vanguard().summaryConfig();
+        const Opm::SummaryConfig& summaryConfig = simulator_.vanguard().summaryConfig();
 
         // Only output RESTART_AUXILIARY asked for by the user.
         const Opm::RestartConfig& restartConfig = simulator_.vanguard().eclState().getRestartConfig();
@@ -216,11 +279,16 @@ public:
                     gasConnectionSaturations_.emplace(std::make_pair(index, 0.0));
                 }
             }
+            compileCellRequests_();
         }
 
         // always allocate memory for temperature
         temperature_.resize(bufferSize, 0.0);
 
+        // the restart quantities of the previous restart step are not evaluated
+        // anymore, but their memory is kept
+        clearRestartBuffers_();
+
         // Only provide restart on restart steps
         if (!restartConfig.getWriteRestartFile(reportStepNum, log) || substep)
             return;
@@ -371,291 +439,254 @@ public:
     /*!
      * \brief Modify the internal buffers according to the intensive quanties relevant
      *        for an element
+     *
+     * Since every element only writes to its own entries of the buffers, this method
+     * may be called for different elements concurrently.
      */
-    void processElement(const ElementContext& elemCtx)
+    void processElement(unsigned globalDofIdx, const IntensiveQuantities& intQuants)
     {
         if (!std::is_same<Discretization, Ewoms::EcfvDiscretization<TypeTag> >::value)
             return;
 
-        const auto& problem = elemCtx.simulator().problem();
-        for (unsigned dofIdx = 0; dofIdx < elemCtx.numPrimaryDof(/*timeIdx=*/0); ++dofIdx) {
-            const auto& intQuants = elemCtx.intensiveQuantities(dofIdx, /*timeIdx=*/0);
-            const auto& fs = intQuants.fluidState();
+        const auto& problem = simulator_.problem();
+        const auto& fs = intQuants.fluidState();
 
-            typedef typename std::remove_const<typename std::remove_reference<decltype(fs)>::type>::type FluidState;
-            unsigned globalDofIdx = elemCtx.globalSpaceIndex(dofIdx, /*timeIdx=*/0);
-            unsigned pvtRegionIdx = elemCtx.primaryVars(dofIdx, /*timeIdx=*/0).pvtRegionIndex();
+        typedef typename std::remove_const<typename std::remove_reference<decltype(fs)>::type>::type FluidState;
+        unsigned pvtRegionIdx = intQuants.pvtRegionIndex();
 
-            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
-                if (saturation_[phaseIdx].size() == 0)
-                    continue;
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
+            if (saturation_[phaseIdx].size() == 0)
+                continue;
 
-                saturation_[phaseIdx][globalDofIdx] = Opm::getValue(fs.saturation(phaseIdx));
-                Opm::Valgrind::CheckDefined(saturation_[phaseIdx][globalDofIdx]);
-            }
+            saturation_[phaseIdx][globalDofIdx] = Opm::getValue(fs.saturation(phaseIdx));
+            Opm::Valgrind::CheckDefined(saturation_[phaseIdx][globalDofIdx]);
+        }
 
-            if (oilPressure_.size() > 0) {
-                oilPressure_[globalDofIdx] = Opm::getValue(fs.pressure(oilPhaseIdx));
-                Opm::Valgrind::CheckDefined(oilPressure_[globalDofIdx]);
-            }
+        if (oilPressure_.size() > 0) {
+            oilPressure_[globalDofIdx] = Opm::getValue(fs.pressure(oilPhaseIdx));
+            Opm::Valgrind::CheckDefined(oilPressure_[globalDofIdx]);
+        }
 
-            if (enableEnergy) {
-                temperature_[globalDofIdx] = Opm::getValue(fs.temperature(oilPhaseIdx));
-                Opm::Valgrind::CheckDefined(temperature_[globalDofIdx]);
-            }
-            if (gasDissolutionFactor_.size() > 0) {
-                Scalar SoMax = elemCtx.problem().maxOilSaturation(globalDofIdx);
-                gasDissolutionFactor_[globalDofIdx] =
-                    FluidSystem::template saturatedDissolutionFactor<FluidState, Scalar>(fs, oilPhaseIdx, pvtRegionIdx, SoMax);
-                Opm::Valgrind::CheckDefined(gasDissolutionFactor_[globalDofIdx]);
+        if (enableEnergy) {
+            temperature_[globalDofIdx] = Opm::getValue(fs.temperature(oilPhaseIdx));
+            Opm::Valgrind::CheckDefined(temperature_[globalDofIdx]);
+        }
+        if (gasDissolutionFactor_.size() > 0) {
+            Scalar SoMax = problem.maxOilSaturation(globalDofIdx);
+            gasDissolutionFactor_[globalDofIdx] =
+                FluidSystem::template saturatedDissolutionFactor<FluidState, Scalar>(fs, oilPhaseIdx, pvtRegionIdx, SoMax);
+            Opm::Valgrind::CheckDefined(gasDissolutionFactor_[globalDofIdx]);
 
-            }
-            if (oilVaporizationFactor_.size() > 0) {
-                Scalar SoMax = elemCtx.problem().maxOilSaturation(globalDofIdx);
-                oilVaporizationFactor_[globalDofIdx] =
-                    FluidSystem::template saturatedDissolutionFactor<FluidState, Scalar>(fs, gasPhaseIdx, pvtRegionIdx, SoMax);
-                Opm::Valgrind::CheckDefined(oilVaporizationFactor_[globalDofIdx]);
+        }
+        if (oilVaporizationFactor_.size() > 0) {
+            Scalar SoMax = problem.maxOilSaturation(globalDofIdx);
+            oilVaporizationFactor_[globalDofIdx] =
+                FluidSystem::template saturatedDissolutionFactor<FluidState, Scalar>(fs, gasPhaseIdx, pvtRegionIdx, SoMax);
+            Opm::Valgrind::CheckDefined(oilVaporizationFactor_[globalDofIdx]);
 
-            }
-            if (gasFormationVolumeFactor_.size() > 0) {
-                gasFormationVolumeFactor_[globalDofIdx] =
-                    1.0/FluidSystem::template inverseFormationVolumeFactor<FluidState, Scalar>(fs, gasPhaseIdx, pvtRegionIdx);
-                Opm::Valgrind::CheckDefined(gasFormationVolumeFactor_[globalDofIdx]);
+        }
+        if (gasFormationVolumeFactor_.size() > 0) {
+            gasFormationVolumeFactor_[globalDofIdx] =
+                1.0/FluidSystem::template inverseFormationVolumeFactor<FluidState, Scalar>(fs, gasPhaseIdx, pvtRegionIdx);
+            Opm::Valgrind::CheckDefined(gasFormationVolumeFactor_[globalDofIdx]);
 
-            }
-            if (saturatedOilFormationVolumeFactor_.size() > 0) {
-                saturatedOilFormationVolumeFactor_[globalDofIdx] =
-                    1.0/FluidSystem::template saturatedInverseFormationVolumeFactor<FluidState, Scalar>(fs, oilPhaseIdx, pvtRegionIdx);
-                Opm::Valgrind::CheckDefined(saturatedOilFormationVolumeFactor_[globalDofIdx]);
+        }
+        if (saturatedOilFormationVolumeFactor_.size() > 0) {
+            saturatedOilFormationVolumeFactor_[globalDofIdx] =
+                1.0/FluidSystem::template saturatedInverseFormationVolumeFactor<FluidState, Scalar>(fs, oilPhaseIdx, pvtRegionIdx);
+            Opm::Valgrind::CheckDefined(saturatedOilFormationVolumeFactor_[globalDofIdx]);
 
-            }
-            if (oilSaturationPressure_.size() > 0) {
-                oilSaturationPressure_[globalDofIdx] =
-                    FluidSystem::template saturationPressure<FluidState, Scalar>(fs, oilPhaseIdx, pvtRegionIdx);
-                Opm::Valgrind::CheckDefined(oilSaturationPressure_[globalDofIdx]);
+        }
+        if (oilSaturationPressure_.size() > 0) {
+            oilSaturationPressure_[globalDofIdx] =
+                FluidSystem::template saturationPressure<FluidState, Scalar>(fs, oilPhaseIdx, pvtRegionIdx);
+            Opm::Valgrind::CheckDefined(oilSaturationPressure_[globalDofIdx]);
 
-            }
+        }
 
-            if (rs_.size()) {
-                rs_[globalDofIdx] = Opm::getValue(fs.Rs());
-                Opm::Valgrind::CheckDefined(rs_[globalDofIdx]);
-            }
+        if (rs_.size()) {
+            rs_[globalDofIdx] = Opm::getValue(fs.Rs());
+            Opm::Valgrind::CheckDefined(rs_[globalDofIdx]);
+        }
 
-            if (rv_.size()) {
-                rv_[globalDofIdx] = Opm::getValue(fs.Rv());
-                Opm::Valgrind::CheckDefined(rv_[globalDofIdx]);
-            }
+        if (rv_.size()) {
+            rv_[globalDofIdx] = Opm::getValue(fs.Rv());
+            Opm::Valgrind::CheckDefined(rv_[globalDofIdx]);
+        }
 
-            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
-                if (invB_[phaseIdx].size() == 0)
-                    continue;
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
+            if (invB_[phaseIdx].size() == 0)
+                continue;
 
-                invB_[phaseIdx][globalDofIdx] = Opm::getValue(fs.invB(phaseIdx));
-                Opm::Valgrind::CheckDefined(invB_[phaseIdx][globalDofIdx]);
-            }
+            invB_[phaseIdx][globalDofIdx] = Opm::getValue(fs.invB(phaseIdx));
+            Opm::Valgrind::CheckDefined(invB_[phaseIdx][globalDofIdx]);
+        }
 
-            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
-                if (density_[phaseIdx].size() == 0)
-                    continue;
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
+            if (density_[phaseIdx].size() == 0)
+                continue;
 
-                density_[phaseIdx][globalDofIdx] = Opm::getValue(fs.density(phaseIdx));
-                Opm::Valgrind::CheckDefined(density_[phaseIdx][globalDofIdx]);
-            }
+            density_[phaseIdx][globalDofIdx] = Opm::getValue(fs.density(phaseIdx));
+            Opm::Valgrind::CheckDefined(density_[phaseIdx][globalDofIdx]);
+        }
 
-            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
-                if (viscosity_[phaseIdx].size() == 0)
-                    continue;
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
+            if (viscosity_[phaseIdx].size() == 0)
+                continue;
 
-                viscosity_[phaseIdx][globalDofIdx] = Opm::getValue(fs.viscosity(phaseIdx));
-                Opm::Valgrind::CheckDefined(viscosity_[phaseIdx][globalDofIdx]);
-            }
+            viscosity_[phaseIdx][globalDofIdx] = Opm::getValue(fs.viscosity(phaseIdx));
+            Opm::Valgrind::CheckDefined(viscosity_[phaseIdx][globalDofIdx]);
+        }
 
-            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
-                if (relativePermeability_[phaseIdx].size() == 0)
-                    continue;
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++ phaseIdx) {
+            if (relativePermeability_[phaseIdx].size() == 0)
+                continue;
 
-                relativePermeability_[phaseIdx][globalDofIdx] = Opm::getValue(intQuants.relativePermeability(phaseIdx));
-                Opm::Valgrind::CheckDefined(relativePermeability_[phaseIdx][globalDofIdx]);
-            }
+            relativePermeability_[phaseIdx][globalDofIdx] = Opm::getValue(intQuants.relativePermeability(phaseIdx));
+            Opm::Valgrind::CheckDefined(relativePermeability_[phaseIdx][globalDofIdx]);
+        }
 
-            if (sSol_.size() > 0) {
-                sSol_[globalDofIdx] = intQuants.solventSaturation().value();
-            }
+        if (sSol_.size() > 0) {
+            sSol_[globalDofIdx] = intQuants.solventSaturation().value();
+        }
 
-            if (cPolymer_.size() > 0) {
-                cPolymer_[globalDofIdx] = intQuants.polymerConcentration().value();
-            }
+        if (cPolymer_.size() > 0) {
+            cPolymer_[globalDofIdx] = intQuants.polymerConcentration().value();
+        }
 
-            if (bubblePointPressure_.size() > 0) {
-                try {
-                    bubblePointPressure_[globalDofIdx] = Opm::getValue(FluidSystem::bubblePointPressure(fs, intQuants.pvtRegionIndex()));
-                }
-                catch (const Opm::NumericalIssue&) {
-                    const auto cartesianIdx = elemCtx.simulator().vanguard().grid().globalCell()[globalDofIdx];
-                    failedCellsPb_.push_back(cartesianIdx);
-                }
+        if (bubblePointPressure_.size() > 0) {
+            try {
+                bubblePointPressure_[globalDofIdx] = Opm::getValue(FluidSystem::bubblePointPressure(fs, intQuants.pvtRegionIndex()));
             }
-            if (dewPointPressure_.size() > 0) {
-                try {
-                    dewPointPressure_[globalDofIdx] = Opm::getValue(FluidSystem::dewPointPressure(fs, intQuants.pvtRegionIndex()));
-                }
-                catch (const Opm::NumericalIssue&) {
-                    const auto cartesianIdx = elemCtx.simulator().vanguard().grid().globalCell()[globalDofIdx];
-                    failedCellsPd_.push_back(cartesianIdx);
-                }
+            catch (const Opm::NumericalIssue&) {
+                const auto cartesianIdx = simulator_.vanguard().grid().globalCell()[globalDofIdx];
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                failedCellsPb_.push_back(cartesianIdx);
             }
-
-            if (soMax_.size() > 0)
-                soMax_[globalDofIdx] =
-                    std::max(Opm::getValue(fs.saturation(oilPhaseIdx)),
-                             problem.maxOilSaturation(globalDofIdx));
-
-            if (swMax_.size() > 0)
-                swMax_[globalDofIdx] =
-                    std::max(Opm::getValue(fs.saturation(waterPhaseIdx)),
-                             problem.maxWaterSaturation(globalDofIdx));
-
-            if (minimumOilPressure_.size() > 0)
-                minimumOilPressure_[globalDofIdx] =
-                    std::min(Opm::getValue(fs.pressure(oilPhaseIdx)),
-                             problem.minOilPressure(globalDofIdx));
-
-            if (overburdenPressure_.size() > 0)
-                overburdenPressure_[globalDofIdx] = problem.overburdenPressure(globalDofIdx);
-
-            if (rockCompPorvMultiplier_.size() > 0)
-                rockCompPorvMultiplier_[globalDofIdx] = problem.template rockCompPoroMultiplier<Scalar>(intQuants, globalDofIdx);
-
-            if (rockCompTransMultiplier_.size() > 0)
-                rockCompTransMultiplier_[globalDofIdx] = problem.template rockCompTransMultiplier<Scalar>(intQuants, globalDofIdx);
-
-            const auto& matLawManager = problem.materialLawManager();
-            if (matLawManager->enableHysteresis()) {
-                if (pcSwMdcOw_.size() > 0 && krnSwMdcOw_.size() > 0) {
-                    matLawManager->oilWaterHysteresisParams(
-                                pcSwMdcOw_[globalDofIdx],
-                                krnSwMdcOw_[globalDofIdx],
-                                globalDofIdx);
-                }
-                if (pcSwMdcGo_.size() > 0 && krnSwMdcGo_.size() > 0) {
-                    matLawManager->gasOilHysteresisParams(
-                                pcSwMdcGo_[globalDofIdx],
-                                krnSwMdcGo_[globalDofIdx],
-                                globalDofIdx);
-                }
+        }
+        if (dewPointPressure_.size() > 0) {
+            try {
+                dewPointPressure_[globalDofIdx] = Opm::getValue(FluidSystem::dewPointPressure(fs, intQuants.pvtRegionIndex()));
+            }
+            catch (const Opm::NumericalIssue&) {
+                const auto cartesianIdx = simulator_.vanguard().grid().globalCell()[globalDofIdx];
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                failedCellsPd_.push_back(cartesianIdx);
             }
+        }
 
+        if (soMax_.size() > 0)
+            soMax_[globalDofIdx] =
+                std::max(Opm::getValue(fs.saturation(oilPhaseIdx)),
+                         problem.maxOilSaturation(globalDofIdx));
 
-            if (ppcw_.size() > 0)
-                ppcw_[globalDofIdx] = matLawManager->oilWaterScaledEpsInfoDrainage(globalDofIdx).maxPcow;
+        if (swMax_.size() > 0)
+            swMax_[globalDofIdx] =
+                std::max(Opm::getValue(fs.saturation(waterPhaseIdx)),
+                         problem.maxWaterSaturation(globalDofIdx));
 
-            // hack to make the intial output of rs and rv Ecl compatible.
-            // For cells with swat == 1 Ecl outputs; rs = rsSat and rv=rvSat, in all but the initial step
-            // where it outputs rs and rv values calculated by the initialization. To be compatible we overwrite
-            // rs and rv with the values computed in the initially.
-            // Volume factors, densities and viscosities need to be recalculated with the updated rs and rv values.
-            // This can be removed when ebos has 100% controll over output
-            if (elemCtx.simulator().episodeIndex() < 0 && FluidSystem::phaseIsActive(oilPhaseIdx) && FluidSystem::phaseIsActive(gasPhaseIdx)) {
+        if (minimumOilPressure_.size() > 0)
+            minimumOilPressure_[globalDofIdx] =
+                std::min(Opm::getValue(fs.pressure(oilPhaseIdx)),
+                         problem.minOilPressure(globalDofIdx));
 
-                const auto& fsInitial = problem.initialFluidState(globalDofIdx);
+        if (overburdenPressure_.size() > 0)
+            overburdenPressure_[globalDofIdx] = problem.overburdenPressure(globalDofIdx);
 
-                // use initial rs and rv values
-                if (rv_.size() > 0)
-                    rv_[globalDofIdx] = fsInitial.Rv();
+        if (rockCompPorvMultiplier_.size() > 0)
+            rockCompPorvMultiplier_[globalDofIdx] = problem.template rockCompPoroMultiplier<Scalar>(intQuants, globalDofIdx);
 
-                if (rs_.size() > 0)
-                    rs_[globalDofIdx] = fsInitial.Rs();
+        if (rockCompTransMultiplier_.size() > 0)
+            rockCompTransMultiplier_[globalDofIdx] = problem.template rockCompTransMultiplier<Scalar>(intQuants, globalDofIdx);
 
-                // re-compute the volume factors, viscosities and densities if asked for
-                if (density_[oilPhaseIdx].size() > 0)
-                    density_[oilPhaseIdx][globalDofIdx] = FluidSystem::density(fsInitial,
+        const auto& matLawManager = problem.materialLawManager();
+        if (matLawManager->enableHysteresis()) {
+            if (pcSwMdcOw_.size() > 0 && krnSwMdcOw_.size() > 0) {
+                matLawManager->oilWaterHysteresisParams(
+                            pcSwMdcOw_[globalDofIdx],
+                            krnSwMdcOw_[globalDofIdx],
+                            globalDofIdx);
+            }
+            if (pcSwMdcGo_.size() > 0 && krnSwMdcGo_.size() > 0) {
+                matLawManager->gasOilHysteresisParams(
+                            pcSwMdcGo_[globalDofIdx],
+                            krnSwMdcGo_[globalDofIdx],
+                            globalDofIdx);
+            }
+        }
+
+
+        if (ppcw_.size() > 0)
+            ppcw_[globalDofIdx] = matLawManager->oilWaterScaledEpsInfoDrainage(globalDofIdx).maxPcow;
+
+        // hack to make the intial output of rs and rv Ecl compatible.
+        // For cells with swat == 1 Ecl outputs; rs = rsSat and rv=rvSat, in all but the initial step
+        // where it outputs rs and rv values calculated by the initialization. To be compatible we overwrite
+        // rs and rv with the values computed in the initially.
+        // Volume factors, densities and viscosities need to be recalculated with the updated rs and rv values.
+        // This can be removed when ebos has 100% controll over output
+        if (simulator_.episodeIndex() < 0 && FluidSystem::phaseIsActive(oilPhaseIdx) && FluidSystem::phaseIsActive(gasPhaseIdx)) {
+
+            const auto& fsInitial = problem.initialFluidState(globalDofIdx);
+
+            // use initial rs and rv values
+            if (rv_.size() > 0)
+                rv_[globalDofIdx] = fsInitial.Rv();
+
+            if (rs_.size() > 0)
+                rs_[globalDofIdx] = fsInitial.Rs();
+
+            // re-compute the volume factors, viscosities and densities if asked for
+            if (density_[oilPhaseIdx].size() > 0)
+                density_[oilPhaseIdx][globalDofIdx] = FluidSystem::density(fsInitial,
+                                                                           oilPhaseIdx,
+                                                                           intQuants.pvtRegionIndex());
+            if (density_[gasPhaseIdx].size() > 0)
+                density_[gasPhaseIdx][globalDofIdx] = FluidSystem::density(fsInitial,
+                                                                           gasPhaseIdx,
+                                                                           intQuants.pvtRegionIndex());
+
+            if (invB_[oilPhaseIdx].size() > 0)
+                invB_[oilPhaseIdx][globalDofIdx] = FluidSystem::inverseFormationVolumeFactor(fsInitial,
+                                                                                             oilPhaseIdx,
+                                                                                             intQuants.pvtRegionIndex());
+            if (invB_[gasPhaseIdx].size() > 0)
+                invB_[gasPhaseIdx][globalDofIdx] = FluidSystem::inverseFormationVolumeFactor(fsInitial,
+                                                                                             gasPhaseIdx,
+                                                                                             intQuants.pvtRegionIndex());
+            if (viscosity_[oilPhaseIdx].size() > 0)
+                viscosity_[oilPhaseIdx][globalDofIdx] = FluidSystem::viscosity(fsInitial,
                                                                                oilPhaseIdx,
                                                                                intQuants.pvtRegionIndex());
-                if (density_[gasPhaseIdx].size() > 0)
-                    density_[gasPhaseIdx][globalDofIdx] = FluidSystem::density(fsInitial,
+            if (viscosity_[gasPhaseIdx].size() > 0)
+                viscosity_[gasPhaseIdx][globalDofIdx] = FluidSystem::viscosity(fsInitial,
                                                                                gasPhaseIdx,
                                                                                intQuants.pvtRegionIndex());
+        }
 
-                if (invB_[oilPhaseIdx].size() > 0)
-                    invB_[oilPhaseIdx][globalDofIdx] = FluidSystem::inverseFormationVolumeFactor(fsInitial,
-                                                                                                 oilPhaseIdx,
-                                                                                                 intQuants.pvtRegionIndex());
-                if (invB_[gasPhaseIdx].size() > 0)
-                    invB_[gasPhaseIdx][globalDofIdx] = FluidSystem::inverseFormationVolumeFactor(fsInitial,
-                                                                                                 gasPhaseIdx,
-                                                                                                 intQuants.pvtRegionIndex());
-                if (viscosity_[oilPhaseIdx].size() > 0)
-                    viscosity_[oilPhaseIdx][globalDofIdx] = FluidSystem::viscosity(fsInitial,
-                                                                                   oilPhaseIdx,
-                                                                                   intQuants.pvtRegionIndex());
-                if (viscosity_[gasPhaseIdx].size() > 0)
-                    viscosity_[gasPhaseIdx][globalDofIdx] = FluidSystem::viscosity(fsInitial,
-                                                                                   gasPhaseIdx,
-                                                                                   intQuants.pvtRegionIndex());
-            }
+        // Add fluid in Place values
+        updateFluidInPlace_(globalDofIdx, intQuants);
 
-            // Add fluid in Place values
-            updateFluidInPlace_(elemCtx, dofIdx);
-
-            // Adding block data
-            const auto cartesianIdx = elemCtx.simulator().vanguard().grid().globalCell()[globalDofIdx];
-            for (auto& val: blockData_) {
-                const auto& key = val.first;
-                int cartesianIdxBlock = key.second - 1;
-                if (cartesianIdx == cartesianIdxBlock) {
-                    if (key.first == "BWSAT")
-                        val.second = Opm::getValue(fs.saturation(waterPhaseIdx));
-                    else if (key.first == "BGSAT")
-                        val.second = Opm::getValue(fs.saturation(gasPhaseIdx));
-                    else if (key.first == "BOSAT")
-                        val.second = 1. - Opm::getValue(fs.saturation(gasPhaseIdx)) - Opm::getValue(fs.saturation(waterPhaseIdx));
-                    else if (key.first == "BPR")
-                        val.second = Opm::getValue(fs.pressure(oilPhaseIdx));
-                    else if (key.first == "BWKR" || key.first == "BKRW")
-                        val.second = Opm::getValue(intQuants.relativePermeability(waterPhaseIdx));
-                    else if (key.first == "BGKR" || key.first == "BKRG")
-                        val.second = Opm::getValue(intQuants.relativePermeability(gasPhaseIdx));
-                    else if (key.first == "BOKR" || key.first == "BKRO")
-                        val.second = Opm::getValue(intQuants.relativePermeability(oilPhaseIdx));
-                    else if (key.first == "BWPC")
-                        val.second = Opm::getValue(fs.pressure(oilPhaseIdx)) - Opm::getValue(fs.pressure(waterPhaseIdx));
-                    else if (key.first == "BGPC")
-                        val.second = Opm::getValue(fs.pressure(gasPhaseIdx)) - Opm::getValue(fs.pressure(oilPhaseIdx));
-                    else if (key.first == "BVWAT" || key.first == "BWVIS")
-                        val.second = Opm::getValue(fs.viscosity(waterPhaseIdx));
-                    else if (key.first == "BVGAS" || key.first == "BGVIS")
-                        val.second = Opm::getValue(fs.viscosity(gasPhaseIdx));
-                    else if (key.first == "BVOIL" || key.first == "BOVIS")
-                        val.second = Opm::getValue(fs.viscosity(oilPhaseIdx));
-                    else {
-                        std::string logstring = "Keyword '";
-                        logstring.append(key.first);
-                        logstring.append("' is unhandled for output to file.");
-                        Opm::OpmLog::warning("Unhandled output keyword", logstring);
-                    }
-                }
-            }
-
-            // Adding Well RFT data
-            if (oilConnectionPressures_.count(cartesianIdx) > 0) {
-                oilConnectionPressures_[cartesianIdx] = Opm::getValue(fs.pressure(oilPhaseIdx));
-            }
-            if (waterConnectionSaturations_.count(cartesianIdx) > 0) {
-                waterConnectionSaturations_[cartesianIdx] = Opm::getValue(fs.saturation(waterPhaseIdx));
-            }
-            if (gasConnectionSaturations_.count(cartesianIdx) > 0) {
-                gasConnectionSaturations_[cartesianIdx] = Opm::getValue(fs.saturation(gasPhaseIdx));
+        // Adding block data and well RFT data
+        if (!cellRequestOffsets_.empty()) {
+            for (unsigned reqIdx = cellRequestOffsets_[globalDofIdx]; reqIdx < cellRequestOffsets_[globalDofIdx + 1]; ++reqIdx) {
+                const auto& request = cellRequests_[reqIdx];
+                *request.value = cellQuantity_(request.quantity, intQuants);
             }
+        }
 
-            // tracers
-            const auto& tracerModel = simulator_.problem().tracerModel();
-            if (tracerConcentrations_.size()>0) {
-                for (int tracerIdx = 0; tracerIdx < tracerModel.numTracers(); tracerIdx++){
-                    if (tracerConcentrations_[tracerIdx].size() == 0)
-                        continue;
+        // tracers
+        const auto& tracerModel = simulator_.problem().tracerModel();
+        if (tracerConcentrations_.size()>0) {
+            for (int tracerIdx = 0; tracerIdx < tracerModel.numTracers(); tracerIdx++){
+                if (tracerConcentrations_[tracerIdx].size() == 0)
+                    continue;
 
-                    tracerConcentrations_[tracerIdx][globalDofIdx] = tracerModel.tracerConcentration(tracerIdx, globalDofIdx);
-                }
+                tracerConcentrations_[tracerIdx][globalDofIdx] = tracerModel.tracerConcentration(tracerIdx, globalDofIdx);
             }
         }
     }
@@ -774,10 +805,14 @@ public:
         oilConnectionPressures_.clear();
         waterConnectionSaturations_.clear();
         gasConnectionSaturations_.clear();
+        compileCellRequests_();
     }
 
     /*!
-     * \brief Move all buffers to data::Solution.
+     * \brief Copy all buffers to data::Solution.
+     *
+     * The buffers are copied instead of moved, so their memory can be reused
+     * for the next report step.
      */
     void assignToSolution(Opm::data::Solution& sol)
     {
@@ -785,119 +820,119 @@ public:
             return;
 
         if (oilPressure_.size() > 0) {
-            sol.insert("PRESSURE", Opm::UnitSystem::measure::pressure, std::move(oilPressure_), Opm::data::TargetType::RESTART_SOLUTION);
+            sol.insert("PRESSURE", Opm::UnitSystem::measure::pressure, oilPressure_, Opm::data::TargetType::RESTART_SOLUTION);
         }
 
         if (enableEnergy) {
-            sol.insert("TEMP", Opm::UnitSystem::measure::temperature, std::move(temperature_), Opm::data::TargetType::RESTART_SOLUTION);
+            sol.insert("TEMP", Opm::UnitSystem::measure::temperature, temperature_, Opm::data::TargetType::RESTART_SOLUTION);
         }
 
         if (FluidSystem::phaseIsActive(waterPhaseIdx) && saturation_[waterPhaseIdx].size() > 0) {
-            sol.insert("SWAT", Opm::UnitSystem::measure::identity, std::move(saturation_[waterPhaseIdx]), Opm::data::TargetType::RESTART_SOLUTION);
+            sol.insert("SWAT", Opm::UnitSystem::measure::identity, saturation_[waterPhaseIdx], Opm::data::TargetType::RESTART_SOLUTION);
         }
         if (FluidSystem::phaseIsActive(gasPhaseIdx) && saturation_[gasPhaseIdx].size() > 0) {
-            sol.insert("SGAS", Opm::UnitSystem::measure::identity, std::move(saturation_[gasPhaseIdx]), Opm::data::TargetType::RESTART_SOLUTION);
+            sol.insert("SGAS", Opm::UnitSystem::measure::identity, saturation_[gasPhaseIdx], Opm::data::TargetType::RESTART_SOLUTION);
         }
         if (ppcw_.size() > 0) {
-            sol.insert ("PPCW", Opm::UnitSystem::measure::pressure, std::move(ppcw_), Opm::data::TargetType::RESTART_SOLUTION);
+            sol.insert ("PPCW", Opm::UnitSystem::measure::pressure, ppcw_, Opm::data::TargetType::RESTART_SOLUTION);
         }
 
         if (gasDissolutionFactor_.size() > 0) {
-            sol.insert("RSSAT", Opm::UnitSystem::measure::gas_oil_ratio, std::move(gasDissolutionFactor_), Opm::data::TargetType::RESTART_AUXILIARY);
+            sol.insert("RSSAT", Opm::UnitSystem::measure::gas_oil_ratio, gasDissolutionFactor_, Opm::data::TargetType::RESTART_AUXILIARY);
 
         }
         if (oilVaporizationFactor_.size() > 0) {
-            sol.insert("RVSAT", Opm::UnitSystem::measure::oil_gas_ratio, std::move(oilVaporizationFactor_), Opm::data::TargetType::RESTART_AUXILIARY);
+            sol.insert("RVSAT", Opm::UnitSystem::measure::oil_gas_ratio, oilVaporizationFactor_, Opm::data::TargetType::RESTART_AUXILIARY);
         }
         if (rs_.size() > 0) {
-            sol.insert("RS", Opm::UnitSystem::measure::gas_oil_ratio, std::move(rs_), Opm::data::TargetType::RESTART_SOLUTION);
+            sol.insert("RS", Opm::UnitSystem::measure::gas_oil_ratio, rs_, Opm::data::TargetType::RESTART_SOLUTION);
 
         }
         if (rv_.size() > 0) {
-            sol.insert("RV", Opm::UnitSystem::measure::oil_gas_ratio, std::move(rv_), Opm::data::TargetType::RESTART_SOLUTION);
+            sol.insert("RV", Opm::UnitSystem::measure::oil_gas_ratio, rv_, Opm::data::TargetType::RESTART_SOLUTION);
         }
         if (invB_[waterPhaseIdx].size() > 0) {
-            sol.insert("1OVERBW", Opm::UnitSystem::measure::water_inverse_formation_volume_factor, std::move(invB_[waterPhaseIdx]), Opm::data::TargetType::RESTART_AUXILIARY);
+            sol.insert("1OVERBW", Opm::UnitSystem::measure::water_inverse_formation_volume_factor, invB_[waterPhaseIdx], Opm::data::TargetType::RESTART_AUXILIARY);
         }
         if (invB_[oilPhaseIdx].size() > 0) {
-            sol.insert("1OVERBO", Opm::UnitSystem::measure::oil_inverse_formation_volume_factor, std::move(invB_[oilPhaseIdx]), Opm::data::TargetType::RESTART_AUXILIARY);
+            sol.insert("1OVERBO", Opm::UnitSystem::measure::oil_inverse_formation_volume_factor, invB_[oilPhaseIdx], Opm::data::TargetType::RESTART_AUXILIARY);
         }
         if (invB_[gasPhaseIdx].size() > 0) {
-            sol.insert("1OVERBG", Opm::UnitSystem::measure::gas_inverse_formation_volume_factor, std::move(invB_[gasPhaseIdx]), Opm::data::TargetType::RESTART_AUXILIARY);
+            sol.insert("1OVERBG", Opm::UnitSystem::measure::gas_inverse_formation_volume_factor, invB_[gasPhaseIdx], Opm::data::TargetType::RESTART_AUXILIARY);
         }
 
         if (density_[waterPhaseIdx].size() > 0) {
-            sol.insert("WAT_DEN", Opm::UnitSystem::measure::density, std::move(density_[waterPhaseIdx]), Opm::data::TargetType::RESTART_AUXILIARY);
+            sol.insert("WAT_DEN", Opm::UnitSystem::measure::density, density_[waterPhaseIdx], Opm::data::TargetType::RESTART_AUXILIARY);
         }
         if (density_[oilPhaseIdx].size() > 0) {
-            sol.insert("OIL_DEN", Opm::UnitSystem::measure::density, std::move(density_[oilPhaseIdx]), Opm::data::TargetType::RESTART_AUXILIARY);
+            sol.insert("OIL_DEN", Opm::UnitSystem::measure::density, density_[oilPhaseIdx], Opm::data::TargetType::RESTART_AUXILIARY);
         }
         if (density_[gasPhaseIdx].size() > 0) {
-            sol.insert("GAS_DEN", Opm::UnitSystem::measure::density, std::move(density_[gasPhaseIdx]), Opm::data::TargetType::RESTART_AUXILIARY);
+            sol.insert("GAS_DEN", Opm::UnitSystem::measure::density, density_[gasPhaseIdx], Opm::data::TargetType::RESTART_AUXILIARY);
         }
 
         if (viscosity_[waterPhaseIdx].size() > 0) {
-            sol.insert("WAT_VISC", Opm::UnitSystem::measure::viscosity, std::move(viscosity_[waterPhaseIdx]), Opm::data::TargetType::RESTART_AUXILIARY);
+            sol.insert("WAT_VISC", Opm::UnitSystem::measure::viscosity, viscosity_[waterPhaseIdx], Opm::data::TargetType::RESTART_AUXILIARY);
         }
         if (viscosity_[oilPhaseIdx].size() > 0) {
-            sol.insert("OIL_VISC", Opm::UnitSystem::measure::viscosity, std::move(viscosity_[oilPhaseIdx]), Opm::data::TargetType::RESTART_AUXILIARY);
+            sol.insert("OIL_VISC", Opm::UnitSystem::measure::viscosity, viscosity_[oilPhaseIdx], Opm::data::TargetType::RESTART_AUXILIARY);
         }
         if (viscosity_[gasPhaseIdx].size() > 0) {
-            sol.insert("GAS_VISC", Opm::UnitSystem::measure::viscosity, std::move(viscosity_[gasPhaseIdx]), Opm::data::TargetType::RESTART_AUXILIARY);
+            sol.insert("GAS_VISC", Opm::UnitSystem::measure::viscosity, viscosity_[gasPhaseIdx], Opm::data::TargetType::RESTART_AUXILIARY);
         }
 
         if (relativePermeability_[waterPhaseIdx].size() > 0) {
-            sol.insert("WATKR", Opm::UnitSystem::measure::identity, std::move(relativePermeability_[waterPhaseIdx]), Opm::data::TargetType::RESTART_AUXILIARY);
+            sol.insert("WATKR", Opm::UnitSystem::measure::identity, relativePermeability_[waterPhaseIdx], Opm::data::TargetType::RESTART_AUXILIARY);
         }
         if (relativePermeability_[oilPhaseIdx].size() > 0) {
-            sol.insert("OILKR", Opm::UnitSystem::measure::identity, std::move(relativePermeability_[oilPhaseIdx]), Opm::data::TargetType::RESTART_AUXILIARY);
+            sol.insert("OILKR", Opm::UnitSystem::measure::identity, relativePermeability_[oilPhaseIdx], Opm::data::TargetType::RESTART_AUXILIARY);
         }
         if (relativePermeability_[gasPhaseIdx].size() > 0) {
-            sol.insert("GASKR", Opm::UnitSystem::measure::identity, std::move(relativePermeability_[gasPhaseIdx]), Opm::data::TargetType::RESTART_AUXILIARY);
+            sol.insert("GASKR", Opm::UnitSystem::measure::identity, relativePermeability_[gasPhaseIdx], Opm::data::TargetType::RESTART_AUXILIARY);
         }
 
         if (pcSwMdcOw_.size() > 0)
-            sol.insert ("PCSWM_OW", Opm::UnitSystem::measure::identity, std::move(pcSwMdcOw_), Opm::data::TargetType::RESTART_AUXILIARY);
+            sol.insert ("PCSWM_OW", Opm::UnitSystem::measure::identity, pcSwMdcOw_, Opm::data::TargetType::RESTART_AUXILIARY);
 
         if (krnSwMdcOw_.size() > 0)
-            sol.insert ("KRNSW_OW", Opm::UnitSystem::measure::identity, std::move(krnSwMdcOw_), Opm::data::TargetType::RESTART_AUXILIARY);
+            sol.insert ("KRNSW_OW", Opm::UnitSystem::measure::identity, krnSwMdcOw_, Opm::data::TargetType::RESTART_AUXILIARY);
 
         if (pcSwMdcGo_.size() > 0)
-            sol.insert ("PCSWM_GO", Opm::UnitSystem::measure::identity, std::move(pcSwMdcGo_), Opm::data::TargetType::RESTART_AUXILIARY);
+            sol.insert ("PCSWM_GO", Opm::UnitSystem::measure::identity, pcSwMdcGo_, Opm::data::TargetType::RESTART_AUXILIARY);
 
         if (krnSwMdcGo_.size() > 0)
-            sol.insert ("KRNSW_GO", Opm::UnitSystem::measure::identity, std::move(krnSwMdcGo_), Opm::data::TargetType::RESTART_AUXILIARY);
+            sol.insert ("KRNSW_GO", Opm::UnitSystem::measure::identity, krnSwMdcGo_, Opm::data::TargetType::RESTART_AUXILIARY);
 
         if (soMax_.size() > 0)
-            sol.insert ("SOMAX", Opm::UnitSystem::measure::identity, std::move(soMax_), Opm::data::TargetType::RESTART_SOLUTION);
+            sol.insert ("SOMAX", Opm::UnitSystem::measure::identity, soMax_, Opm::data::TargetType::RESTART_SOLUTION);
 
         if (sSol_.size() > 0)
-            sol.insert ("SSOLVENT", Opm::UnitSystem::measure::identity, std::move(sSol_), Opm::data::TargetType::RESTART_SOLUTION);
+            sol.insert ("SSOLVENT", Opm::UnitSystem::measure::identity, sSol_, Opm::data::TargetType::RESTART_SOLUTION);
 
         if (cPolymer_.size() > 0)
-            sol.insert ("POLYMER", Opm::UnitSystem::measure::identity, std::move(cPolymer_), Opm::data::TargetType::RESTART_SOLUTION);
+            sol.insert ("POLYMER", Opm::UnitSystem::measure::identity, cPolymer_, Opm::data::TargetType::RESTART_SOLUTION);
 
         if (dewPointPressure_.size() > 0)
-            sol.insert ("PDEW", Opm::UnitSystem::measure::pressure, std::move(dewPointPressure_), Opm::data::TargetType::RESTART_AUXILIARY);
+            sol.insert ("PDEW", Opm::UnitSystem::measure::pressure, dewPointPressure_, Opm::data::TargetType::RESTART_AUXILIARY);
 
         if (bubblePointPressure_.size() > 0)
-            sol.insert ("PBUB", Opm::UnitSystem::measure::pressure, std::move(bubblePointPressure_), Opm::data::TargetType::RESTART_AUXILIARY);
+            sol.insert ("PBUB", Opm::UnitSystem::measure::pressure, bubblePointPressure_, Opm::data::TargetType::RESTART_AUXILIARY);
 
 
         if (swMax_.size() > 0)
-            sol.insert ("SWMAX", Opm::UnitSystem::measure::identity, std::move(swMax_), Opm::data::TargetType::RESTART_SOLUTION);
+            sol.insert ("SWMAX", Opm::UnitSystem::measure::identity, swMax_, Opm::data::TargetType::RESTART_SOLUTION);
 
         if (minimumOilPressure_.size() > 0)
-            sol.insert ("PRESROCC", Opm::UnitSystem::measure::pressure, std::move(minimumOilPressure_), Opm::data::TargetType::RESTART_SOLUTION);
+            sol.insert ("PRESROCC", Opm::UnitSystem::measure::pressure, minimumOilPressure_, Opm::data::TargetType::RESTART_SOLUTION);
 
         if (overburdenPressure_.size() > 0)
-            sol.insert ("PRES_OVB", Opm::UnitSystem::measure::pressure, std::move(overburdenPressure_), Opm::data::TargetType::RESTART_SOLUTION);
+            sol.insert ("PRES_OVB", Opm::UnitSystem::measure::pressure, overburdenPressure_, Opm::data::TargetType::RESTART_SOLUTION);
 
         if (rockCompPorvMultiplier_.size() > 0)
-            sol.insert ("PORV_RC", Opm::UnitSystem::measure::identity, std::move(rockCompPorvMultiplier_), Opm::data::TargetType::RESTART_SOLUTION);
+            sol.insert ("PORV_RC", Opm::UnitSystem::measure::identity, rockCompPorvMultiplier_, Opm::data::TargetType::RESTART_SOLUTION);
 
         if (rockCompTransMultiplier_.size() > 0)
-            sol.insert ("TMULT_RC", Opm::UnitSystem::measure::identity, std::move(rockCompTransMultiplier_), Opm::data::TargetType::RESTART_SOLUTION);
+            sol.insert ("TMULT_RC", Opm::UnitSystem::measure::identity, rockCompTransMultiplier_, Opm::data::TargetType::RESTART_SOLUTION);
 
 
         // Fluid in place
@@ -914,8 +949,11 @@ public:
         const auto& tracerModel = simulator_.problem().tracerModel();
         if (tracerConcentrations_.size() > 0) {
             for (int tracerIdx = 0; tracerIdx<tracerModel.numTracers(); tracerIdx++){
+                if (tracerConcentrations_[tracerIdx].size() == 0)
+                    continue;
+
                 std::string tmp = tracerModel.tracerName(tracerIdx) + "F";
-                sol.insert(tmp, Opm::UnitSystem::measure::identity, std::move(tracerConcentrations_[tracerIdx]), Opm::data::TargetType::RESTART_SOLUTION);
+                sol.insert(tmp, Opm::UnitSystem::measure::identity, tracerConcentrations_[tracerIdx], Opm::data::TargetType::RESTART_SOLUTION);
             }
         }
     }
@@ -1154,18 +1192,165 @@ public:
 
 private:
 
+    static typename CellQuantity::CellQuantityId blockQuantity_(const std::string& keyword)
+    {
+        if (keyword == "BWSAT")
+            return CellQuantity::WaterSaturation;
+        else if (keyword == "BGSAT")
+            return CellQuantity::GasSaturation;
+        else if (keyword == "BOSAT")
+            return CellQuantity::OilSaturation;
+        else if (keyword == "BPR")
+            return CellQuantity::Pressure;
+        else if (keyword == "BWKR" || keyword == "BKRW")
+            return CellQuantity::WaterRelPerm;
+        else if (keyword == "BGKR" || keyword == "BKRG")
+            return CellQuantity::GasRelPerm;
+        else if (keyword == "BOKR" || keyword == "BKRO")
+            return CellQuantity::OilRelPerm;
+        else if (keyword == "BWPC")
+            return CellQuantity::WaterCapPressure;
+        else if (keyword == "BGPC")
+            return CellQuantity::GasCapPressure;
+        else if (keyword == "BVWAT" || keyword == "BWVIS")
+            return CellQuantity::WaterViscosity;
+        else if (keyword == "BVGAS" || keyword == "BGVIS")
+            return CellQuantity::GasViscosity;
+        else if (keyword == "BVOIL" || keyword == "BOVIS")
+            return CellQuantity::OilViscosity;
+
+        return CellQuantity::Unhandled;
+    }
+
+    static double cellQuantity_(typename CellQuantity::CellQuantityId quantity, const IntensiveQuantities& intQuants)
+    {
+        const auto& fs = intQuants.fluidState();
+        switch (quantity) {
+        case CellQuantity::WaterSaturation:
+        case CellQuantity::RftWaterSaturation:
+            return Opm::getValue(fs.saturation(waterPhaseIdx));
+        case CellQuantity::GasSaturation:
+        case CellQuantity::RftGasSaturation:
+            return Opm::getValue(fs.saturation(gasPhaseIdx));
+        case CellQuantity::OilSaturation:
+            return 1. - Opm::getValue(fs.saturation(gasPhaseIdx)) - Opm::getValue(fs.saturation(waterPhaseIdx));
+        case CellQuantity::Pressure:
+        case CellQuantity::RftPressure:
+            return Opm::getValue(fs.pressure(oilPhaseIdx));
+        case CellQuantity::WaterRelPerm:
+            return Opm::getValue(intQuants.relativePermeability(waterPhaseIdx));
+        case CellQuantity::GasRelPerm:
+            return Opm::getValue(intQuants.relativePermeability(gasPhaseIdx));
+        case CellQuantity::OilRelPerm:
+            return Opm::getValue(intQuants.relativePermeability(oilPhaseIdx));
+        case CellQuantity::WaterCapPressure:
+            return Opm::getValue(fs.pressure(oilPhaseIdx)) - Opm::getValue(fs.pressure(waterPhaseIdx));
+        case CellQuantity::GasCapPressure:
+            return Opm::getValue(fs.pressure(gasPhaseIdx)) - Opm::getValue(fs.pressure(oilPhaseIdx));
+        case CellQuantity::WaterViscosity:
+            return Opm::getValue(fs.viscosity(waterPhaseIdx));
+        case CellQuantity::GasViscosity:
+            return Opm::getValue(fs.viscosity(gasPhaseIdx));
+        case CellQuantity::OilViscosity:
+            return Opm::getValue(fs.viscosity(oilPhaseIdx));
+        case CellQuantity::Unhandled:
+            break;
+        }
+        return 0.0;
+    }
+
+    // Empty the buffers which are only evaluated at restart steps. clear() keeps
+    // the memory, so it can be reused by the next restart step.
+    void clearRestartBuffers_()
+    {
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            saturation_[phaseIdx].clear();
+            invB_[phaseIdx].clear();
+            density_[phaseIdx].clear();
+            viscosity_[phaseIdx].clear();
+            relativePermeability_[phaseIdx].clear();
+        }
+        oilPressure_.clear();
+        gasDissolutionFactor_.clear();
+        oilVaporizationFactor_.clear();
+        gasFormationVolumeFactor_.clear();
+        saturatedOilFormationVolumeFactor_.clear();
+        oilSaturationPressure_.clear();
+        rs_.clear();
+        rv_.clear();
+        sSol_.clear();
+        cPolymer_.clear();
+        soMax_.clear();
+        pcSwMdcOw_.clear();
+        krnSwMdcOw_.clear();
+        pcSwMdcGo_.clear();
+        krnSwMdcGo_.clear();
+        ppcw_.clear();
+        bubblePointPressure_.clear();
+        dewPointPressure_.clear();
+        rockCompPorvMultiplier_.clear();
+        rockCompTransMultiplier_.clear();
+        swMax_.clear();
+        overburdenPressure_.clear();
+        minimumOilPressure_.clear();
+        for (auto& tracerConcentration : tracerConcentrations_)
+            tracerConcentration.clear();
+    }
+
+    // Sort the block and RFT requests by the local index of their cell, so that
+    // processElement() only needs to look at the requests of the current element.
+    // The requests point into blockData_ and the RFT maps, so this needs to be
+    // called whenever the RFT maps change.
+    void compileCellRequests_()
+    {
+        // (Cartesian index, request) pairs
+        std::vector<std::pair<int, CellRequest> > requests(blockRequests_);
+        for (auto& val: oilConnectionPressures_) {
+            CellRequest request = { CellQuantity::RftPressure, &val.second };
+            requests.emplace_back(val.first, request);
+        }
+        for (auto& val: waterConnectionSaturations_) {
+            CellRequest request = { CellQuantity::RftWaterSaturation, &val.second };
+            requests.emplace_back(val.first, request);
+        }
+        for (auto& val: gasConnectionSaturations_) {
+            CellRequest request = { CellQuantity::RftGasSaturation, &val.second };
+            requests.emplace_back(val.first, request);
+        }
+
+        cellRequests_.clear();
+        cellRequestOffsets_.clear();
+        if (requests.empty())
+            return;
+
+        const auto cartesianLess = [](const std::pair<int, CellRequest>& a, const std::pair<int, CellRequest>& b)
+                                   { return a.first < b.first; };
+        std::stable_sort(requests.begin(), requests.end(), cartesianLess);
+
+        const auto& globalCell = simulator_.vanguard().grid().globalCell();
+        const unsigned numCells = globalCell.size();
+        cellRequestOffsets_.resize(numCells + 1);
+        for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+            cellRequestOffsets_[cellIdx] = cellRequests_.size();
+
+            const std::pair<int, CellRequest> cell = { globalCell[cellIdx], CellRequest() };
+            const auto range = std::equal_range(requests.begin(), requests.end(), cell, cartesianLess);
+            for (auto it = range.first; it != range.second; ++it)
+                cellRequests_.push_back(it->second);
+        }
+        cellRequestOffsets_[numCells] = cellRequests_.size();
+    }
+
     bool isIORank_() const
     {
         const auto& comm = simulator_.gridView().comm();
         return comm.rank() == 0;
     }
 
-    void updateFluidInPlace_(const ElementContext& elemCtx, unsigned dofIdx)
+    void updateFluidInPlace_(unsigned globalDofIdx, const IntensiveQuantities& intQuants)
     {
 
-        const auto& intQuants = elemCtx.intensiveQuantities(dofIdx, /*timeIdx=*/0);
         const auto& fs = intQuants.fluidState();
-        unsigned globalDofIdx = elemCtx.globalSpaceIndex(dofIdx, /*timeIdx=*/0);
 
         // Fluid in Place calculations
 
@@ -1177,7 +1362,7 @@ private:
         // returned by the intensive quantities can be outside of the physical
         // range [0, 1] in pathetic cases.
         const double pv =
-            elemCtx.simulator().model().dofTotalVolume(globalDofIdx)
+            simulator_.model().dofTotalVolume(globalDofIdx)
             * intQuants.porosity().value();
 
         if (pressureTimesHydrocarbonVolume_.size() > 0 && pressureTimesPoreVolume_.size() > 0) {
@@ -1439,6 +1624,11 @@ private:
 
     const Simulator& simulator_;
 
+    // the arguments of the last call to allocBuffers()
+    unsigned allocBufferSize_;
+    unsigned allocReportStepNum_;
+    bool allocSubstep_;
+
     bool outputFipRestart_;
     bool computeFip_;
     bool forceDisableFipOutput_;
@@ -1483,9 +1673,12 @@ private:
     ScalarBuffer pressureTimesPoreVolume_;
     ScalarBuffer pressureTimesHydrocarbonVolume_;
     std::map<std::pair<std::string, int>, double> blockData_;
-    std::map<size_t, Scalar> oilConnectionPressures_;
-    std::map<size_t, Scalar> waterConnectionSaturations_;
-    std::map<size_t, Scalar> gasConnectionSaturations_;
+    std::map<size_t, double> oilConnectionPressures_;
+    std::map<size_t, double> waterConnectionSaturations_;
+    std::map<size_t, double> gasConnectionSaturations_;
+    std::vector<std::pair<int, CellRequest> > blockRequests_;
+    std::vector<CellRequest> cellRequests_;
+    std::vector<unsigned> cellRequestOffsets_;
     std::vector<ScalarBuffer> tracerConcentrations_;
 };
 } // namespace Ewoms
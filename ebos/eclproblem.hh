@@ -67,6 +67,7 @@
 #include <ewoms/common/pffgridvector.hh>
 #include <ewoms/models/blackoil/blackoilmodel.hh>
 #include <ewoms/disc/ecfv/ecfvdiscretization.hh>
+#include <ewoms/parallel/threadedentityiterator.hh>
 
 #include <opm/material/fluidmatrixinteractions/EclMaterialLawManager.hpp>
 #include <opm/material/thermal/EclThermalLawManager.hpp>
@@ -104,8 +105,10 @@
 #include <boost/date_time.hpp>
 
 #include <set>
+#include <functional>
 #include <vector>
 #include <string>
+#include <stdexcept>
 #include <algorithm>
 
 namespace Ewoms {
@@ -311,6 +314,9 @@ SET_BOOL_PROP(EclBaseProblem, EnableAsyncEclOutput, true);
 // By default, use single precision for the ECL formated results
 SET_BOOL_PROP(EclBaseProblem, EclOutputDoublePrecision, false);
 
+// By default, the cell data of the restart files is collected on the I/O rank
+SET_BOOL_PROP(EclBaseProblem, EclOutputDistributed, false);
+
 // The default location for the ECL output files
 SET_STRING_PROP(EclBaseProblem, OutputDir, ".");
 
@@ -449,6 +455,9 @@ class EclProblem : public GET_PROP_TYPE(TypeTag, BaseProblem)
 
     typedef Opm::UniformXTabulated2DFunction<Scalar> TabulatedTwoDFunction;
 
+    // updates a per-element quantity from the intensive quantities of an element
+    typedef std::function<void(unsigned, const IntensiveQuantities&)> CellUpdater;
+
     struct RockParams {
         Scalar referencePressure;
         Scalar compressibility;
@@ -618,6 +627,9 @@ public:
         maxTimeStepAfterWellEvent_ = EWOMS_GET_PARAM(TypeTag, Scalar, EclMaxTimeStepSizeAfterWellEvent);
         restartShrinkFactor_ = EWOMS_GET_PARAM(TypeTag, Scalar, EclRestartShrinkFactor);
         maxFails_ = EWOMS_GET_PARAM(TypeTag, unsigned, MaxTimeStepDivisions);
+
+        // this is determined at the beginning of each time step
+        recycleFirstIterationStorage_ = false;
     }
 
     /*!
@@ -765,6 +777,65 @@ public:
             aquiferModel_.serialize(res);
     }
 
+    /*!
+     * \brief Write the state of the problem which evolves over the time steps to a
+     *        binary checkpoint or read it from one.
+     *
+     * Besides the history of the individual cells, this covers the aquifers and the
+     * tracers. The primary variables and the wells are taken care of by the
+     * simulator.
+     */
+    template <class Serializer>
+    void checkpoint(Serializer& serializer)
+    {
+        serializer.vector("problem/lastRs", lastRs_);
+        serializer.vector("problem/lastRv", lastRv_);
+        serializer.vector("problem/maxOilSaturation", maxOilSaturation_);
+        serializer.vector("problem/maxWaterSaturation", maxWaterSaturation_);
+        serializer.vector("problem/minOilPressure", minOilPressure_);
+        serializer.vector("problem/maxPolymerAdsorption", maxPolymerAdsorption_);
+
+        if (enableDriftCompensation_) {
+            std::vector<Scalar> drift(drift_.size()*numEq);
+            for (size_t dofIdx = 0; dofIdx < drift_.size(); ++dofIdx)
+                for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx)
+                    drift[dofIdx*numEq + eqIdx] = drift_[dofIdx][eqIdx];
+
+            serializer.vector("problem/drift", drift);
+
+            for (size_t dofIdx = 0; dofIdx < drift_.size(); ++dofIdx)
+                for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx)
+                    drift_[dofIdx][eqIdx] = drift[dofIdx*numEq + eqIdx];
+        }
+
+        if (materialLawManager_->enableHysteresis()) {
+            size_t numElems = this->model().numGridDof();
+            std::vector<Scalar> pcSwMdcOw(numElems);
+            std::vector<Scalar> krnSwMdcOw(numElems);
+            std::vector<Scalar> pcSwMdcGo(numElems);
+            std::vector<Scalar> krnSwMdcGo(numElems);
+            for (size_t elemIdx = 0; elemIdx < numElems; ++elemIdx) {
+                materialLawManager_->oilWaterHysteresisParams(pcSwMdcOw[elemIdx], krnSwMdcOw[elemIdx], elemIdx);
+                materialLawManager_->gasOilHysteresisParams(pcSwMdcGo[elemIdx], krnSwMdcGo[elemIdx], elemIdx);
+            }
+
+            serializer.vector("problem/pcSwMdcOw", pcSwMdcOw);
+            serializer.vector("problem/krnSwMdcOw", krnSwMdcOw);
+            serializer.vector("problem/pcSwMdcGo", pcSwMdcGo);
+            serializer.vector("problem/krnSwMdcGo", krnSwMdcGo);
+
+            for (size_t elemIdx = 0; elemIdx < numElems; ++elemIdx) {
+                materialLawManager_->setOilWaterHysteresisParams(pcSwMdcOw[elemIdx], krnSwMdcOw[elemIdx], elemIdx);
+                materialLawManager_->setGasOilHysteresisParams(pcSwMdcGo[elemIdx], krnSwMdcGo[elemIdx], elemIdx);
+            }
+        }
+
+        if (enableAquifers_)
+            aquiferModel_.checkpoint(serializer);
+
+        tracerModel_.checkpoint(serializer);
+    }
+
     /*!
      * \brief Called by the simulator before an episode begins.
      */
@@ -821,12 +892,15 @@ public:
             tuningEvent = true;
         }
 
-        const bool invalidateFromHyst = updateHysteresis_();
-        const bool invalidateFromMaxOilSat = updateMaxOilSaturation_();
+        std::vector<CellUpdater> cellUpdaters;
+        const bool invalidateFromHyst = addHysteresisUpdater_(cellUpdaters);
+        const bool invalidateFromMaxOilSat = addMaxOilSaturationUpdater_(cellUpdaters);
         const bool doInvalidate = invalidateFromHyst || invalidateFromMaxOilSat;
 
         if (GET_PROP_VALUE(TypeTag, EnablePolymer))
-            updateMaxPolymerAdsorption_();
+            addMaxPolymerAdsorptionUpdater_(cellUpdaters);
+
+        updateCells_(cellUpdaters);
 
         // set up the wells for the next episode.
         wellModel_.beginEpisode();
@@ -870,14 +944,19 @@ public:
         if (enableExperiments) {
             // update maximum water saturation and minimum pressure
             // used when ROCKCOMP is activated
-            const bool invalidateFromMaxWaterSat = updateMaxWaterSaturation_();
-            const bool invalidateFromMinPressure = updateMinPressure_();
+            std::vector<CellUpdater> cellUpdaters;
+            const bool invalidateFromMaxWaterSat = addMaxWaterSaturationUpdater_(cellUpdaters);
+            const bool invalidateFromMinPressure = addMinPressureUpdater_(cellUpdaters);
             invalidateIntensiveQuantities = invalidateFromMaxWaterSat || invalidateFromMinPressure;
+
+            updateCells_(cellUpdaters);
         }
 
         if (invalidateIntensiveQuantities)
             this->model().invalidateIntensiveQuantitiesCache(/*timeIdx=*/0);
 
+        recycleFirstIterationStorage_ = !compositionChangeLimitsDependOnTime_();
+
         wellModel_.beginTimeStep();
         if (enableAquifers_)
             aquiferModel_.beginTimeStep();
@@ -889,12 +968,18 @@ public:
      * \brief Return if the storage term of the first iteration is identical to the storage
      *        term for the solution of the previous time step.
      *
-     * For quite technical reasons, the storage term cannot be recycled if either DRSDT
-     * or DRVDT are active in ebos. Nor if the porosity is changes between timesteps
-     * using a pore volume multiplier (i.e., poreVolumeMultiplier() != 1.0)
+     * For quite technical reasons, the storage term cannot be recycled if DRSDT or DRVDT
+     * allow the dissolution factors to grow during a time step, because the limits for
+     * the old and the new time level differ in this case. Limits of zero (i.e.,
+     * 'DRSDT 0') do not matter because they are the same for both time levels, unless
+     * DRSDT only applies to cells which exhibit free gas ('DRSDT 0 FREE').
+     *
+     * The hysteresis parameters of rock compaction are updated at the beginning of the
+     * time step, but updating them using the solution of the previous time step does not
+     * change the porosity multipliers for that solution, so these do not matter either.
      */
     bool recycleFirstIterationStorage() const
-    { return !drsdtActive_() && !drvdtActive_() && rockCompPoroMult_.empty();  }
+    { return recycleFirstIterationStorage_; }
 
     /*!
      * \brief Called by the simulator before each Newton-Raphson iteration.
@@ -1004,6 +1089,7 @@ public:
 
         bool isSubStep = !EWOMS_GET_PARAM(TypeTag, bool, EnableWriteAllSolutions) && !this->simulator().episodeWillBeOver();
 
+        eclWriter_->prepareOutput(isSubStep);
         eclWriter_->evalSummaryState(isSubStep);
         if (enableEclOutput_)
             eclWriter_->writeOutput(isSubStep);
@@ -1089,6 +1175,19 @@ public:
     Scalar thresholdPressure(unsigned elem1Idx, unsigned elem2Idx) const
     { return thresholdPressures_.thresholdPressure(elem1Idx, elem2Idx); }
 
+    /*!
+     * \brief Returns the threshold pressure [Pa] of the face between two degrees of
+     *        freedom of an element context.
+     */
+    template <class Context>
+    Scalar thresholdPressure(const Context& context,
+                             unsigned OPM_OPTIM_UNUSED fromDofLocalIdx,
+                             unsigned toDofLocalIdx) const
+    {
+        assert(fromDofLocalIdx == 0);
+        return pffDofData_.get(context.element(), toDofLocalIdx).thresholdPressure;
+    }
+
     const EclThresholdPressure<TypeTag>& thresholdPressure() const
     { return thresholdPressures_; }
 
@@ -1135,7 +1234,51 @@ public:
     Scalar dofCenterDepth(const Context& context, unsigned spaceIdx, unsigned timeIdx) const
     {
         unsigned globalSpaceIdx = context.globalSpaceIndex(spaceIdx, timeIdx);
-        return elementCenterDepth_[globalSpaceIdx];
+        return dofCenterDepth(globalSpaceIdx);
+    }
+
+    /*!
+     * \brief Returns the depth of an degree of freedom [m]
+     *
+     * For ECL problems this is defined as the average of the depth of an element and is
+     * thus slightly different from the depth of an element's centroid.
+     */
+    Scalar dofCenterDepth(unsigned globalSpaceIdx) const
+    { return elementCenterDepth_[globalSpaceIdx]; }
+
+    /*!
+     * \brief The static data of the face between the center of a stencil and one of
+     *        its neighbors.
+     *
+     * It is computed once for all faces, so that the flux calculations only need a
+     * single lookup to get all quantities which do not depend on the solution.
+     */
+    struct FaceData
+    {
+        Opm::ConditionalStorage<enableEnergy, Scalar> thermalHalfTrans;
+        Scalar transmissibility;
+        Scalar thresholdPressure;
+
+        // the depth of the stencil's center minus the one of the neighbor
+        Scalar distZ;
+
+        // specifies whether the stencil's center is the upstream degree of freedom if
+        // the pressure difference over the face vanishes: this is the one with the
+        // larger volume or, if the volumes are equal, the one with the smaller index.
+        bool centerIsUpstreamOnTie;
+    };
+
+    /*!
+     * \brief Returns the static data of the face between two degrees of freedom of an
+     *        element context.
+     */
+    template <class Context>
+    const FaceData& faceData(const Context& context,
+                             unsigned OPM_OPTIM_UNUSED fromDofLocalIdx,
+                             unsigned toDofLocalIdx) const
+    {
+        assert(fromDofLocalIdx == 0);
+        return pffDofData_.get(context.element(), toDofLocalIdx);
     }
 
     /*!
@@ -1144,16 +1287,8 @@ public:
     template <class Context>
     Scalar rockCompressibility(const Context& context, unsigned spaceIdx, unsigned timeIdx) const
     {
-        if (rockParams_.empty())
-            return 0.0;
-
-        unsigned tableIdx = 0;
-        if (!rockTableIdx_.empty()) {
-            unsigned globalSpaceIdx = context.globalSpaceIndex(spaceIdx, timeIdx);
-            tableIdx = rockTableIdx_[globalSpaceIdx];
-        }
-
-        return rockParams_[tableIdx].compressibility;
+        unsigned globalSpaceIdx = context.globalSpaceIndex(spaceIdx, timeIdx);
+        return rockCompressibility_[globalSpaceIdx];
     }
 
     /*!
@@ -1162,16 +1297,8 @@ public:
     template <class Context>
     Scalar rockReferencePressure(const Context& context, unsigned spaceIdx, unsigned timeIdx) const
     {
-        if (rockParams_.empty())
-            return 1e5;
-
-        unsigned tableIdx = 0;
-        if (!rockTableIdx_.empty()) {
-            unsigned globalSpaceIdx = context.globalSpaceIndex(spaceIdx, timeIdx);
-            tableIdx = rockTableIdx_[globalSpaceIdx];
-        }
-
-        return rockParams_[tableIdx].referencePressure;
+        unsigned globalSpaceIdx = context.globalSpaceIndex(spaceIdx, timeIdx);
+        return rockReferencePressure_[globalSpaceIdx];
     }
 
     /*!
@@ -1272,12 +1399,7 @@ public:
      * \brief Returns the index the relevant PVT region given a cell index
      */
     unsigned pvtRegionIndex(unsigned elemIdx) const
-    {
-        if (pvtnum_.empty())
-            return 0;
-
-        return pvtnum_[elemIdx];
-    }
+    { return pvtnum_[elemIdx]; }
 
     const std::vector<int>& pvtRegionArray() const
     { return pvtnum_; }
@@ -1293,12 +1415,7 @@ public:
      * \brief Returns the index the relevant saturation function region given a cell index
      */
     unsigned satnumRegionIndex(unsigned elemIdx) const
-    {
-        if (satnum_.empty())
-            return 0;
-
-        return satnum_[elemIdx];
-    }
+    { return satnum_[elemIdx]; }
 
     /*!
      * \brief Returns the index of the relevant region for thermodynmic properties
@@ -1485,6 +1602,8 @@ public:
         // this point, because determining the threshold pressures may require to access
         // the initial solution.
         thresholdPressures_.finishInit();
+        if (thresholdPressures_.hasThresholdPressures())
+            updatePffDofData_();
 
         updateCompositionChangeLimits_();
 
@@ -1862,6 +1981,34 @@ private:
         // the opposite cases should be fine (albeit a bit slower than what's possible)
     }
 
+    // returns true if DRSDT or DRVDT impose different limits for the dissolution factors
+    // of the current and the previous time level in any PVT region
+    bool compositionChangeLimitsDependOnTime_() const
+    {
+        if (drsdtActive_()) {
+            const auto& simulator = this->simulator();
+            int epsiodeIdx = std::max(simulator.episodeIndex(), 0);
+            const auto& oilVaporizationControl = simulator.vanguard().schedule().getOilVaporizationProperties(epsiodeIdx);
+            for (size_t pvtRegionIdx = 0; pvtRegionIdx < maxDRs_.size(); ++pvtRegionIdx) {
+                if (maxDRs_[pvtRegionIdx] > 0.0)
+                    return true;
+
+                // with the 'FREE' option, the Rs of cells without free gas is not
+                // limited, i.e., the limit of a cell changes between the time levels if
+                // free gas appears or vanishes, even if the maximum change is zero
+                if (maxDRs_[pvtRegionIdx] == 0.0 && !oilVaporizationControl.getOption(pvtRegionIdx))
+                    return true;
+            }
+        }
+
+        if (drvdtActive_())
+            for (const auto& maxDRv : maxDRv_)
+                if (maxDRv > 0.0)
+                    return true;
+
+        return false;
+    }
+
     bool drsdtActive_() const
     {
         const auto& simulator = this->simulator();
@@ -1913,6 +2060,41 @@ private:
         }
     }
 
+    // calls all updaters for each element of the grid, including the ones in the ghost
+    // and overlap regions, in a single sweep which is distributed over the threads
+    void updateCells_(const std::vector<CellUpdater>& updaters)
+    {
+        if (updaters.empty())
+            return;
+
+        const auto& simulator = this->simulator();
+        const auto& model = this->model();
+        const auto& elemMapper = this->elementMapper();
+        Ewoms::ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(simulator.vanguard().gridView());
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            ElementContext elemCtx(simulator);
+            ElementIterator elemIt = threadedElemIt.beginParallel();
+            for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
+                const Element& elem = *elemIt;
+                unsigned compressedDofIdx = elemMapper.index(elem);
+
+                // use the cached intensive quantities if possible, else compute them
+                const IntensiveQuantities* iq = model.cachedIntensiveQuantities(compressedDofIdx, /*timeIdx=*/0);
+                if (!iq) {
+                    elemCtx.updatePrimaryStencil(elem);
+                    elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+                    iq = &elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
+                }
+
+                for (const auto& updater : updaters)
+                    updater(compressedDofIdx, *iq);
+            }
+        }
+    }
+
     // update the parameters needed for DRSDT and DRVDT
     void updateCompositionChangeLimits_()
     {
@@ -1922,19 +2104,10 @@ private:
         int epsiodeIdx = std::max(simulator.episodeIndex(), 0);
         const auto& oilVaporizationControl = simulator.vanguard().schedule().getOilVaporizationProperties(epsiodeIdx);
 
+        std::vector<CellUpdater> cellUpdaters;
         if (oilVaporizationControl.drsdtActive()) {
-            ElementContext elemCtx(simulator);
-            const auto& vanguard = simulator.vanguard();
-            auto elemIt = vanguard.gridView().template begin</*codim=*/0>();
-            const auto& elemEndIt = vanguard.gridView().template end</*codim=*/0>();
-            for (; elemIt != elemEndIt; ++elemIt) {
-                const Element& elem = *elemIt;
-
-                elemCtx.updatePrimaryStencil(elem);
-                elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-
-                unsigned compressedDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-                const auto& iq = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
+            cellUpdaters.emplace_back([this, &oilVaporizationControl](unsigned compressedDofIdx, const IntensiveQuantities& iq)
+            {
                 const auto& fs = iq.fluidState();
 
                 typedef typename std::decay<decltype(fs)>::type FluidState;
@@ -1947,24 +2120,14 @@ private:
                                                        Scalar>(fs, iq.pvtRegionIndex());
                 else
                     lastRs_[compressedDofIdx] = std::numeric_limits<Scalar>::infinity();
-            }
+            });
         }
 
         // update the "last Rv" values for all elements, including the ones in the ghost
         // and overlap regions
         if (drvdtActive_()) {
-            ElementContext elemCtx(simulator);
-            const auto& vanguard = simulator.vanguard();
-            auto elemIt = vanguard.gridView().template begin</*codim=*/0>();
-            const auto& elemEndIt = vanguard.gridView().template end</*codim=*/0>();
-            for (; elemIt != elemEndIt; ++elemIt) {
-                const Element& elem = *elemIt;
-
-                elemCtx.updatePrimaryStencil(elem);
-                elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-
-                unsigned compressedDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-                const auto& iq = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
+            cellUpdaters.emplace_back([this](unsigned compressedDofIdx, const IntensiveQuantities& iq)
+            {
                 const auto& fs = iq.fluidState();
 
                 typedef typename std::decay<decltype(fs)>::type FluidState;
@@ -1973,34 +2136,24 @@ private:
                     Opm::BlackOil::template getRv_<FluidSystem,
                                                    FluidState,
                                                    Scalar>(fs, iq.pvtRegionIndex());
-            }
+            });
         }
+
+        updateCells_(cellUpdaters);
     }
 
-    bool updateMaxOilSaturation_()
+    bool addMaxOilSaturationUpdater_(std::vector<CellUpdater>& updaters)
     {
-        const auto& simulator = this->simulator();
-
         // we use VAPPARS
         if (vapparsActive()) {
-            ElementContext elemCtx(simulator);
-            const auto& vanguard = simulator.vanguard();
-            auto elemIt = vanguard.gridView().template begin</*codim=*/0>();
-            const auto& elemEndIt = vanguard.gridView().template end</*codim=*/0>();
-            for (; elemIt != elemEndIt; ++elemIt) {
-                const Element& elem = *elemIt;
-
-                elemCtx.updatePrimaryStencil(elem);
-                elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-
-                unsigned compressedDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-                const auto& iq = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
+            updaters.emplace_back([this](unsigned compressedDofIdx, const IntensiveQuantities& iq)
+            {
                 const auto& fs = iq.fluidState();
 
                 Scalar So = Opm::decay<Scalar>(fs.saturation(oilPhaseIdx));
 
                 maxOilSaturation_[compressedDofIdx] = std::max(maxOilSaturation_[compressedDofIdx], So);
-            }
+            });
 
             // we need to invalidate the intensive quantities cache here because the
             // derivatives of Rs and Rv will most likely have changed
@@ -2010,58 +2163,38 @@ private:
         return false;
     }
 
-    bool updateMaxWaterSaturation_()
+    bool addMaxWaterSaturationUpdater_(std::vector<CellUpdater>& updaters)
     {
         // water compaction is activated in ROCKCOMP
         if (maxWaterSaturation_.size()== 0)
             return false;
 
         maxWaterSaturation_[/*timeIdx=*/1] = maxWaterSaturation_[/*timeIdx=*/0];
-        ElementContext elemCtx(this->simulator());
-        const auto& vanguard = this->simulator().vanguard();
-        auto elemIt = vanguard.gridView().template begin</*codim=*/0>();
-        const auto& elemEndIt = vanguard.gridView().template end</*codim=*/0>();
-        for (; elemIt != elemEndIt; ++elemIt) {
-            const Element& elem = *elemIt;
-
-            elemCtx.updatePrimaryStencil(elem);
-            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-
-            unsigned compressedDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-            const auto& iq = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
+        updaters.emplace_back([this](unsigned compressedDofIdx, const IntensiveQuantities& iq)
+        {
             const auto& fs = iq.fluidState();
 
             Scalar Sw = Opm::decay<Scalar>(fs.saturation(waterPhaseIdx));
             maxWaterSaturation_[compressedDofIdx] = std::max(maxWaterSaturation_[compressedDofIdx], Sw);
-        }
+        });
 
         return true;
     }
 
-    bool updateMinPressure_()
+    bool addMinPressureUpdater_(std::vector<CellUpdater>& updaters)
     {
         // IRREVERS option is used in ROCKCOMP
         if (minOilPressure_.size() == 0)
             return false;
 
-        ElementContext elemCtx(this->simulator());
-        const auto& vanguard = this->simulator().vanguard();
-        auto elemIt = vanguard.gridView().template begin</*codim=*/0>();
-        const auto& elemEndIt = vanguard.gridView().template end</*codim=*/0>();
-        for (; elemIt != elemEndIt; ++elemIt) {
-            const Element& elem = *elemIt;
-
-            elemCtx.updatePrimaryStencil(elem);
-            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-
-            unsigned compressedDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-            const auto& iq = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
+        updaters.emplace_back([this](unsigned compressedDofIdx, const IntensiveQuantities& iq)
+        {
             const auto& fs = iq.fluidState();
 
             minOilPressure_[compressedDofIdx] =
                 std::min(minOilPressure_[compressedDofIdx],
                          Opm::getValue(fs.pressure(oilPhaseIdx)));
-        }
+        });
 
         return true;
     }
@@ -2130,6 +2263,23 @@ private:
             }
         }
 
+        // resolve the rock compressibility parameters for each element, so that the
+        // intensive quantities do not need to look up the region first. without the
+        // ROCK keyword, the rock is incompressible.
+        unsigned numElements = vanguard.gridView().size(0);
+        rockCompressibility_.resize(numElements, 0.0);
+        rockReferencePressure_.resize(numElements, 1e5);
+        if (!rockParams_.empty()) {
+            for (unsigned elemIdx = 0; elemIdx < numElements; ++ elemIdx) {
+                unsigned tableIdx = 0;
+                if (!rockTableIdx_.empty())
+                    tableIdx = rockTableIdx_[elemIdx];
+
+                rockCompressibility_[elemIdx] = rockParams_[tableIdx].compressibility;
+                rockReferencePressure_[elemIdx] = rockParams_[tableIdx].referencePressure;
+            }
+        }
+
         // Store overburden pressure pr element
         const auto& overburdTables = eclState.getTableManager().getOverburdTables();
         if (!overburdTables.empty()) {
@@ -2727,50 +2877,27 @@ private:
     }
 
     // update the hysteresis parameters of the material laws for the whole grid
-    bool updateHysteresis_()
+    bool addHysteresisUpdater_(std::vector<CellUpdater>& updaters)
     {
         if (!materialLawManager_->enableHysteresis())
             return false;
 
         // we need to update the hysteresis data for _all_ elements (i.e., not just the
         // interior ones) to avoid desynchronization of the processes in the parallel case!
-        const auto& simulator = this->simulator();
-        ElementContext elemCtx(simulator);
-        const auto& vanguard = simulator.vanguard();
-        auto elemIt = vanguard.gridView().template begin</*codim=*/0>();
-        const auto& elemEndIt = vanguard.gridView().template end</*codim=*/0>();
-        for (; elemIt != elemEndIt; ++elemIt) {
-            const Element& elem = *elemIt;
-
-            elemCtx.updatePrimaryStencil(elem);
-            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-
-            unsigned compressedDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-            const auto& intQuants = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
+        updaters.emplace_back([this](unsigned compressedDofIdx, const IntensiveQuantities& intQuants)
+        {
             materialLawManager_->updateHysteresis(intQuants.fluidState(), compressedDofIdx);
-        }
+        });
         return true;
     }
 
-    void updateMaxPolymerAdsorption_()
+    void addMaxPolymerAdsorptionUpdater_(std::vector<CellUpdater>& updaters)
     {
         // we need to update the max polymer adsoption data for all elements
-        const auto& simulator = this->simulator();
-        ElementContext elemCtx(simulator);
-        const auto& vanguard = simulator.vanguard();
-        auto elemIt = vanguard.gridView().template begin</*codim=*/0>();
-        const auto& elemEndIt = vanguard.gridView().template end</*codim=*/0>();
-        for (; elemIt != elemEndIt; ++elemIt) {
-            const Element& elem = *elemIt;
-
-            elemCtx.updatePrimaryStencil(elem);
-            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-
-            unsigned compressedDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-            const auto& intQuants = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
-
+        updaters.emplace_back([this](unsigned compressedDofIdx, const IntensiveQuantities& intQuants)
+        {
             maxPolymerAdsorption_[compressedDofIdx] = std::max(maxPolymerAdsorption_[compressedDofIdx] , Opm::scalarValue(intQuants.polymerAdsorption()));
-        }
+        });
     }
 
     void updatePvtnum_()
@@ -2778,14 +2905,18 @@ private:
         const auto& simulator = this->simulator();
         const auto& eclState = simulator.vanguard().eclState();
         const auto& eclProps = eclState.get3DProperties();
+        const auto& vanguard = simulator.vanguard();
 
-        if (!eclProps.hasDeckIntGridProperty("PVTNUM"))
+        // all elements belong to the first region if the keyword is not present. the
+        // array is always populated, so the region lookups do not need to check for
+        // that.
+        unsigned numElems = vanguard.gridView().size(/*codim=*/0);
+        if (!eclProps.hasDeckIntGridProperty("PVTNUM")) {
+            pvtnum_.assign(numElems, 0);
             return;
+        }
 
         const auto& pvtnumData = eclProps.getIntGridProperty("PVTNUM").getData();
-        const auto& vanguard = simulator.vanguard();
-
-        unsigned numElems = vanguard.gridView().size(/*codim=*/0);
         pvtnum_.resize(numElems);
         for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx) {
             unsigned cartElemIdx = vanguard.cartesianIndex(elemIdx);
@@ -2798,14 +2929,16 @@ private:
         const auto& simulator = this->simulator();
         const auto& eclState = simulator.vanguard().eclState();
         const auto& eclProps = eclState.get3DProperties();
+        const auto& vanguard = simulator.vanguard();
 
-        if (!eclProps.hasDeckIntGridProperty("SATNUM"))
+        // see updatePvtnum_()
+        unsigned numElems = vanguard.gridView().size(/*codim=*/0);
+        if (!eclProps.hasDeckIntGridProperty("SATNUM")) {
+            satnum_.assign(numElems, 0);
             return;
+        }
 
         const auto& satnumData = eclProps.getIntGridProperty("SATNUM").getData();
-        const auto& vanguard = simulator.vanguard();
-
-        unsigned numElems = vanguard.gridView().size(/*codim=*/0);
         satnum_.resize(numElems);
         for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx) {
             unsigned cartElemIdx = vanguard.cartesianIndex(elemIdx);
@@ -2853,17 +2986,11 @@ private:
         }
     }
 
-    struct PffDofData_
-    {
-        Opm::ConditionalStorage<enableEnergy, Scalar> thermalHalfTrans;
-        Scalar transmissibility;
-    };
-
     // update the prefetch friendly data object
     void updatePffDofData_()
     {
         const auto& distFn =
-            [this](PffDofData_& dofData,
+            [this](FaceData& dofData,
                    const Stencil& stencil,
                    unsigned localDofIdx)
             -> void
@@ -2873,7 +3000,21 @@ private:
             unsigned globalElemIdx = elementMapper.index(stencil.entity(localDofIdx));
             if (localDofIdx != 0) {
                 unsigned globalCenterElemIdx = elementMapper.index(stencil.entity(/*dofIdx=*/0));
-                dofData.transmissibility = transmissibilities_.transmissibility(globalCenterElemIdx, globalElemIdx);
+                const int faceIdx = transmissibilities_.faceIndex(globalCenterElemIdx, globalElemIdx);
+                if (faceIdx < 0)
+                    throw std::out_of_range("The elements "+std::to_string(globalCenterElemIdx)+" and "
+                                            +std::to_string(globalElemIdx)+" do not share a face");
+
+                dofData.transmissibility = transmissibilities_.faceTransmissibility(faceIdx);
+                dofData.thresholdPressure = thresholdPressures_.faceThresholdPressure(faceIdx);
+                dofData.distZ = elementCenterDepth_[globalCenterElemIdx] - elementCenterDepth_[globalElemIdx];
+
+                Scalar centerVolume = stencil.subControlVolume(/*dofIdx=*/0).volume();
+                Scalar volume = stencil.subControlVolume(localDofIdx).volume();
+                if (centerVolume != volume)
+                    dofData.centerIsUpstreamOnTie = centerVolume > volume;
+                else
+                    dofData.centerIsUpstreamOnTie = globalCenterElemIdx < globalElemIdx;
 
                 if (enableEnergy)
                     *dofData.thermalHalfTrans = transmissibilities_.thermalHalfTrans(globalCenterElemIdx, globalElemIdx);
@@ -3086,6 +3227,8 @@ private:
 
     std::vector<unsigned short> rockTableIdx_;
     std::vector<RockParams> rockParams_;
+    std::vector<Scalar> rockCompressibility_;
+    std::vector<Scalar> rockReferencePressure_;
 
     std::vector<Scalar> maxPolymerAdsorption_;
 
@@ -3120,7 +3263,7 @@ private:
     bool enableEclOutput_;
     std::unique_ptr<EclWriterType> eclWriter_;
 
-    PffGridVector<GridView, Stencil, PffDofData_, DofMapper> pffDofData_;
+    PffGridVector<GridView, Stencil, FaceData, DofMapper> pffDofData_;
     TracerModel tracerModel_;
 
     bool nonTrivialBoundaryConditions_;
@@ -3145,6 +3288,7 @@ private:
     Scalar maxTimeStepSize_;
     Scalar restartShrinkFactor_;
     unsigned maxFails_;
+    bool recycleFirstIterationStorage_;
     Scalar minTimeStepSize_;
 };
 
@@ -137,15 +137,16 @@ public:
           but it will *not* be properly initialized with numerical values. The
           values must instead come from the THPRES vector in the restart file.
         */
-        if (simConfig.getThresholdPressure().restart())
-            return;
+        if (!simConfig.getThresholdPressure().restart()) {
+            // allocate the array which specifies the threshold pressures
+            thpres_.resize(numEquilRegions_*numEquilRegions_, 0.0);
+            thpresDefault_.resize(numEquilRegions_*numEquilRegions_, 0.0);
 
-        // allocate the array which specifies the threshold pressures
-        thpres_.resize(numEquilRegions_*numEquilRegions_, 0.0);
-        thpresDefault_.resize(numEquilRegions_*numEquilRegions_, 0.0);
+            computeDefaultThresholdPressures_();
+            applyExplicitThresholdPressures_();
+        }
 
-        computeDefaultThresholdPressures_();
-        applyExplicitThresholdPressures_();
+        updateFaceThresholdPressures_();
     }
 
     /*!
@@ -158,9 +159,66 @@ public:
      */
     Scalar thresholdPressure(int elem1Idx, int elem2Idx) const
     {
-        if (!enableThresholdPressure_)
+        if (!hasThresholdPressures())
+            return 0.0;
+
+        const auto& transmissibilities = simulator_.problem().eclTransmissibilities();
+        const int faceIdx = transmissibilities.faceIndex(elem1Idx, elem2Idx);
+        if (faceIdx < 0)
             return 0.0;
 
+        return thpresFace_[faceIdx];
+    }
+
+    /*!
+     * \brief Returns the theshold pressure [Pa] of a face.
+     *
+     * The faces are numbered like the ones of the transmissibilities, see
+     * EclTransmissibility::faceIndex().
+     */
+    Scalar faceThresholdPressure(unsigned faceIdx) const
+    {
+        if (!hasThresholdPressures())
+            return 0.0;
+
+        assert(faceIdx < thpresFace_.size());
+        return thpresFace_[faceIdx];
+    }
+
+    /*!
+     * \brief Returns true if at least one face exhibits a non-zero threshold pressure.
+     */
+    bool hasThresholdPressures() const
+    { return !thpresFace_.empty(); }
+
+    /*!
+     * \brief Return the raw array with the threshold pressures
+     *
+     * This is used for the restart capability.
+     */
+    const std::vector<Scalar>& data() const
+    { return thpres_; }
+
+    /*!
+     * \brief Set the threshold pressures from a raw array
+     *
+     * This is used for the restart capability.
+     */
+    void setFromRestart(const std::vector<Scalar>& values)
+    {
+        thpres_ = values;
+
+        // the restart file may be loaded before or after finishInit() was called. in
+        // the former case, the per-face values will be determined by finishInit()
+        if (!elemEquilRegion_.empty())
+            updateFaceThresholdPressures_();
+    }
+
+private:
+    // compute the threshold pressure of a pair of elements from the EQUIL region and
+    // fault data.
+    Scalar computeThresholdPressure_(unsigned elem1Idx, unsigned elem2Idx) const
+    {
         if (enableExperiments) {
             // threshold pressure accross faults
             if (!thpresftValues_.empty()) {
@@ -197,23 +255,34 @@ public:
         return thpres_[equilRegion1Idx*numEquilRegions_ + equilRegion2Idx];
     }
 
-    /*!
-     * \brief Return the raw array with the threshold pressures
-     *
-     * This is used for the restart capability.
-     */
-    const std::vector<Scalar>& data() const
-    { return thpres_; }
+    // evaluate the threshold pressures for all faces of the grid. the result uses the
+    // face numbering of the transmissibilities and is left empty if no face exhibits a
+    // threshold pressure, so that the common case does not cost any lookups.
+    void updateFaceThresholdPressures_()
+    {
+        thpresFace_.clear();
+        if (!enableThresholdPressure_ || thpres_.empty())
+            return;
 
-    /*!
-     * \brief Set the threshold pressures from a raw array
-     *
-     * This is used for the restart capability.
-     */
-    void setFromRestart(const std::vector<Scalar>& values)
-    { thpres_ = values; }
+        const auto& transmissibilities = simulator_.problem().eclTransmissibilities();
+        const unsigned numElements = elemEquilRegion_.size();
+        std::vector<Scalar> thpresFace(transmissibilities.numFaces(), 0.0);
+        bool hasNonZero = false;
+        for (unsigned elemIdx = 0; elemIdx < numElements; ++elemIdx) {
+            for (unsigned faceIdx = transmissibilities.faceBegin(elemIdx);
+                 faceIdx < transmissibilities.faceEnd(elemIdx);
+                 ++faceIdx)
+            {
+                unsigned neighborIdx = transmissibilities.faceNeighbor(faceIdx);
+                thpresFace[faceIdx] = computeThresholdPressure_(elemIdx, neighborIdx);
+                hasNonZero = hasNonZero || thpresFace[faceIdx] != 0.0;
+            }
+        }
+
+        if (hasNonZero)
+            thpresFace_ = std::move(thpresFace);
+    }
 
-private:
     // compute the defaults of the threshold pressures using the initial condition
     void computeDefaultThresholdPressures_()
     {
@@ -389,6 +458,7 @@ private:
 
     std::vector<Scalar> thpresDefault_;
     std::vector<Scalar> thpres_;
+    std::vector<Scalar> thpresFace_;
     unsigned numEquilRegions_;
     std::vector<unsigned char> elemEquilRegion_;
 
@@ -331,6 +331,29 @@ public:
     void deserialize(Restarter& res OPM_UNUSED)
     { /* not implemented */ }
 
+    /*!
+     * \brief Write the tracer concentrations to a binary checkpoint or read them from
+     *        one.
+     *
+     * The storage terms of the tracers are recomputed at the beginning of each time
+     * step, so they are not part of the checkpoint.
+     */
+    template <class Serializer>
+    void checkpoint(Serializer& serializer)
+    {
+        for (int tracerIdx = 0; tracerIdx < numTracers(); ++tracerIdx) {
+            auto& concentration = tracerConcentration_[tracerIdx];
+            std::vector<Scalar> values(concentration.size());
+            for (size_t globalDofIdx = 0; globalDofIdx < values.size(); ++globalDofIdx)
+                values[globalDofIdx] = concentration[globalDofIdx];
+
+            serializer.vector("tracers/" + tracerNames_[tracerIdx], values);
+
+            for (size_t globalDofIdx = 0; globalDofIdx < values.size(); ++globalDofIdx)
+                concentration[globalDofIdx] = values[globalDofIdx];
+        }
+    }
+
 protected:
     // evaluate storage term for all tracers in a single cell
     template <class LhsEval>
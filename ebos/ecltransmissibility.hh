@@ -31,6 +31,7 @@
 #include <ebos/nncsorter.hpp>
 
 #include <ewoms/common/propertysystem.hh>
+#include <ewoms/parallel/threadedentityiterator.hh>
 
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
 #include <opm/parser/eclipse/EclipseState/Grid/GridProperties.hpp>
@@ -50,9 +51,13 @@
 #include <dune/common/fvector.hh>
 #include <dune/common/fmatrix.hh>
 
+#include <algorithm>
 #include <array>
+#include <exception>
+#include <numeric>
+#include <stdexcept>
+#include <string>
 #include <vector>
-#include <unordered_map>
 
 BEGIN_PROPERTIES
 
@@ -82,6 +87,8 @@ class EclTransmissibility
     typedef typename GET_PROP_TYPE(TypeTag, Vanguard) Vanguard;
     typedef typename GET_PROP_TYPE(TypeTag, ElementMapper) ElementMapper;
     typedef typename GridView::Intersection Intersection;
+    typedef typename GridView::template Codim<0>::Entity Element;
+    typedef typename GridView::template Codim<0>::Iterator ElementIterator;
 
     static const bool enableEnergy = GET_PROP_VALUE(TypeTag, EnableEnergy);
 
@@ -91,8 +98,6 @@ class EclTransmissibility
     typedef Dune::FieldMatrix<Scalar, dimWorld, dimWorld> DimMatrix;
     typedef Dune::FieldVector<Scalar, dimWorld> DimVector;
 
-    static const unsigned elemIdxShift = 32; // bits
-
 public:
 
     EclTransmissibility(const Vanguard& vanguard)
@@ -131,8 +136,6 @@ public:
         const auto& cartMapper = vanguard_.cartesianIndexMapper();
         const auto& eclState = vanguard_.eclState();
         const auto& eclGrid = eclState.getInputGrid();
-        const auto& cartDims = cartMapper.cartesianDimensions();
-        auto& transMult = eclState.getTransMult();
 #if DUNE_VERSION_NEWER(DUNE_GRID, 2,6)
         ElementMapper elemMapper(gridView, Dune::mcmgElementLayout());
 #else
@@ -169,212 +172,48 @@ public:
                     axisCentroids[axisIdx][elemIdx][dimIdx] = centroid[dimIdx];
         }
 
-        // reserving some space in the hashmap upfront saves quite a bit of time because
-        // resizes are costly for hashmaps and there would be quite a few of them if we
-        // would not have a rough idea of how large the final map will be (the rough idea
-        // is a conforming Cartesian grid).
-        trans_.clear();
-        trans_.reserve(numElements*3*1.05);
+        // determine the faces between the elements and on the domain boundary. the
+        // transmissibilities are then stored in flat arrays indexed by face. the grid
+        // does not change after it has been created, so this only needs to be done the
+        // first time the transmissibilities are computed.
+        if (faceOffsets_.size() != numElements + 1)
+            updateFaceTopology_(elemMapper);
 
-        transBoundary_.clear();
+        trans_.assign(faceNeighbors_.size(), 0.0);
+        transBoundary_.assign(boundaryOffsets_.back(), 0.0);
 
         // if energy is enabled, let's do the same for the "thermal half transmissibilities"
         if (enableEnergy) {
-            thermalHalfTrans_->clear();
-            thermalHalfTrans_->reserve(numElements*6*1.05);
-
-            thermalHalfTransBoundary_.clear();
+            thermalHalfTrans_->assign(2*faceNeighbors_.size(), 0.0);
+            thermalHalfTransBoundary_.assign(boundaryOffsets_.back(), 0.0);
         }
 
-        // compute the transmissibilities for all intersections
-        elemIt = gridView.template begin</*codim=*/ 0>();
-        for (; elemIt != elemEndIt; ++elemIt) {
-            const auto& elem = *elemIt;
-            unsigned elemIdx = elemMapper.index(elem);
-
-            auto isIt = gridView.ibegin(elem);
-            const auto& isEndIt = gridView.iend(elem);
-            unsigned boundaryIsIdx = 0;
-            for (; isIt != isEndIt; ++ isIt) {
-                // store intersection, this might be costly
-                const auto& intersection = *isIt;
-
-                // deal with grid boundaries
-                if (intersection.boundary()) {
-                    // compute the transmissibilty for the boundary intersection
-                    const auto& geometry = intersection.geometry();
-                    const auto& faceCenterInside = geometry.center();
-
-                    auto faceAreaNormal = intersection.centerUnitOuterNormal();
-                    faceAreaNormal *= geometry.volume();
-
-                    Scalar transBoundaryIs;
-                    computeHalfTrans_(transBoundaryIs,
-                                      faceAreaNormal,
-                                      intersection.indexInInside(),
-                                      distanceVector_(faceCenterInside,
-                                                      intersection.indexInInside(),
-                                                      elemIdx,
-                                                      axisCentroids),
-                                      permeability_[elemIdx]);
-
-                    // normally there would be two half-transmissibilities that would be
-                    // averaged. on the grid boundary there only is the half
-                    // transmissibility of the interior element.
-                    transBoundary_[std::make_pair(elemIdx, boundaryIsIdx)] = transBoundaryIs;
-
-                    // for boundary intersections we also need to compute the thermal
-                    // half transmissibilities
-                    if (enableEnergy) {
-                        const auto& n = intersection.centerUnitOuterNormal();
-                        const auto& inPos = elem.geometry().center();
-                        const auto& outPos = intersection.geometry().center();
-                        const auto& d = outPos - inPos;
-
-                        // eWoms expects fluxes to be area specific, i.e. we must *not*
-                        // the transmissibility with the face area here
-                        Scalar thermalHalfTrans = std::abs(n*d)/(d*d);
-
-                        thermalHalfTransBoundary_[std::make_pair(elemIdx, boundaryIsIdx)] =
-                            thermalHalfTrans;
-                    }
-
-                    ++ boundaryIsIdx;
-                    continue;
-                }
-
-                if (!intersection.neighbor())
-                    // elements can be on process boundaries, i.e. they are not on the
-                    // domain boundary yet they don't have neighbors.
-                    continue;
-
-                const auto& outsideElem = intersection.outside();
-                unsigned outsideElemIdx = elemMapper.index(outsideElem);
-
-                // update the "thermal half transmissibility" for the intersection
-                if (enableEnergy) {
-                    const auto& n = intersection.centerUnitOuterNormal();
-                    Scalar A = intersection.geometry().volume();
-
-                    const auto& inPos = elem.geometry().center();
-                    const auto& outPos = intersection.geometry().center();
-                    const auto& d = outPos - inPos;
-
-                    (*thermalHalfTrans_)[directionalIsId_(elemIdx, outsideElemIdx)] =
-                        A * (n*d)/(d*d);
-                }
-
-                // we only need to calculate a face's transmissibility
-                // once...
-                if (elemIdx > outsideElemIdx)
-                    continue;
-
-                unsigned insideCartElemIdx = cartMapper.cartesianIndex(elemIdx);
-                unsigned outsideCartElemIdx = cartMapper.cartesianIndex(outsideElemIdx);
-
-                // local indices of the faces of the inside and
-                // outside elements which contain the intersection
-                int insideFaceIdx  = intersection.indexInInside();
-                int outsideFaceIdx = intersection.indexInOutside();
-
-                if (insideFaceIdx == -1) {
-                    // NNC. Set zero transmissibility, as it will be
-                    // *added to* by applyNncToGridTrans_() later.
-                    assert(outsideFaceIdx == -1);
-                    trans_[isId_(elemIdx, outsideElemIdx)] = 0.0;
-                    continue;
+        // compute the transmissibilities for all intersections. every entry of the
+        // face arrays is written by exactly one element, so the elements can be
+        // processed in parallel. exceptions must not leave the parallel region, so
+        // the first one is stored and thrown again after all threads have finished.
+        std::exception_ptr exceptionPtr;
+        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            ElementIterator threadElemIt = threadedElemIt.beginParallel();
+            for (; !threadedElemIt.isFinished(threadElemIt); threadElemIt = threadedElemIt.increment()) {
+                try {
+                    updateElementTransmissibilities_(*threadElemIt, elemMapper, axisCentroids, ntg);
                 }
-
-                DimVector faceCenterInside;
-                DimVector faceCenterOutside;
-                DimVector faceAreaNormal;
-
-                typename std::is_same<Grid, Dune::CpGrid>::type isCpGrid;
-                computeFaceProperties(intersection,
-                                      elemIdx,
-                                      insideFaceIdx,
-                                      outsideElemIdx,
-                                      outsideFaceIdx,
-                                      faceCenterInside,
-                                      faceCenterOutside,
-                                      faceAreaNormal,
-                                      isCpGrid);
-
-                Scalar halfTrans1;
-                Scalar halfTrans2;
-
-                computeHalfTrans_(halfTrans1,
-                                  faceAreaNormal,
-                                  insideFaceIdx,
-                                  distanceVector_(faceCenterInside,
-                                                  intersection.indexInInside(),
-                                                  elemIdx,
-                                                  axisCentroids),
-                                  permeability_[elemIdx]);
-                computeHalfTrans_(halfTrans2,
-                                  faceAreaNormal,
-                                  outsideFaceIdx,
-                                  distanceVector_(faceCenterOutside,
-                                                  intersection.indexInOutside(),
-                                                  outsideElemIdx,
-                                                  axisCentroids),
-                                  permeability_[outsideElemIdx]);
-
-                applyNtg_(halfTrans1, insideFaceIdx, insideCartElemIdx, ntg);
-                applyNtg_(halfTrans2, outsideFaceIdx, outsideCartElemIdx, ntg);
-
-                // convert half transmissibilities to full face
-                // transmissibilities using the harmonic mean
-                Scalar trans;
-                if (std::abs(halfTrans1) < 1e-30 || std::abs(halfTrans2) < 1e-30)
-                    // avoid division by zero
-                    trans = 0.0;
-                else
-                    trans = 1.0 / (1.0/halfTrans1 + 1.0/halfTrans2);
-
-                // apply the full face transmissibility multipliers
-                // for the inside ...
-
-                // The MULTZ needs special case if the option is ALL
-                // Then the smallest multiplier is applied.
-                // Default is to apply the top and bottom multiplier
-                bool useSmallestMultiplier = eclGrid.getMultzOption() == Opm::PinchMode::ModeEnum::ALL;
-                if (useSmallestMultiplier)
-                    applyAllZMultipliers_(trans, insideFaceIdx, insideCartElemIdx, outsideCartElemIdx, transMult, cartDims);
-                else
-                    applyMultipliers_(trans, insideFaceIdx, insideCartElemIdx, transMult);
-                // ... and outside elements
-                applyMultipliers_(trans, outsideFaceIdx, outsideCartElemIdx, transMult);
-
-                // apply the region multipliers (cf. the MULTREGT keyword)
-                Opm::FaceDir::DirEnum faceDir;
-                switch (insideFaceIdx) {
-                case 0:
-                case 1:
-                    faceDir = Opm::FaceDir::XPlus;
-                    break;
-
-                case 2:
-                case 3:
-                    faceDir = Opm::FaceDir::YPlus;
-                    break;
-
-                case 4:
-                case 5:
-                    faceDir = Opm::FaceDir::ZPlus;
-                    break;
-
-                default:
-                    throw std::logic_error("Could not determine a face direction");
+                catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                    if (!exceptionPtr)
+                        exceptionPtr = std::current_exception();
                 }
-
-                trans *= transMult.getRegionMultiplier(insideCartElemIdx,
-                                                       outsideCartElemIdx,
-                                                       faceDir);
-
-                trans_[isId_(elemIdx, outsideElemIdx)] = trans;
             }
         }
+        if (exceptionPtr)
+            std::rethrow_exception(exceptionPtr);
 
         // potentially overwrite and/or modify  transmissibilities based on input from deck
         updateFromEclState_();
@@ -409,13 +248,78 @@ public:
      * \brief Return the transmissibility for the intersection between two elements.
      */
     Scalar transmissibility(unsigned elemIdx1, unsigned elemIdx2) const
-    { return trans_.at(isId_(elemIdx1, elemIdx2)); }
+    {
+        const int faceIdx = faceIndex(elemIdx1, elemIdx2);
+        if (faceIdx < 0)
+            throw std::out_of_range("The elements "+std::to_string(elemIdx1)+" and "
+                                    +std::to_string(elemIdx2)+" do not share a face");
+
+        return trans_[faceIdx];
+    }
+
+    /*!
+     * \brief Return the transmissibility of a face given by its index.
+     */
+    Scalar faceTransmissibility(unsigned faceIdx) const
+    { return trans_[faceIdx]; }
+
+    /*!
+     * \brief Return the number of faces between elements.
+     */
+    unsigned numFaces() const
+    { return trans_.size(); }
+
+    /*!
+     * \brief Return the index of the face between two elements or -1 if the elements
+     *        are not connected.
+     *
+     * The faces are numbered consecutively by the element with the smaller index and
+     * then by the element with the larger index.
+     */
+    int faceIndex(unsigned elemIdx1, unsigned elemIdx2) const
+    {
+        const unsigned rowIdx = std::min(elemIdx1, elemIdx2);
+        const unsigned colIdx = std::max(elemIdx1, elemIdx2);
+        if (rowIdx + 1 >= faceOffsets_.size())
+            return -1;
+
+        const auto rowBegin = faceNeighbors_.begin() + faceOffsets_[rowIdx];
+        const auto rowEnd = faceNeighbors_.begin() + faceOffsets_[rowIdx + 1];
+        const auto it = std::lower_bound(rowBegin, rowEnd, colIdx);
+        if (it == rowEnd || *it != colIdx)
+            return -1;
+
+        return it - faceNeighbors_.begin();
+    }
+
+    /*!
+     * \brief Return the index of the first face for which an element is the one with
+     *        the smaller index.
+     */
+    unsigned faceBegin(unsigned elemIdx) const
+    { return faceOffsets_[elemIdx]; }
+
+    /*!
+     * \brief Return the index after the last face for which an element is the one with
+     *        the smaller index.
+     */
+    unsigned faceEnd(unsigned elemIdx) const
+    { return faceOffsets_[elemIdx + 1]; }
+
+    /*!
+     * \brief Return the element with the larger index which is adjacent to a face.
+     */
+    unsigned faceNeighbor(unsigned faceIdx) const
+    { return faceNeighbors_[faceIdx]; }
 
     /*!
      * \brief Return the transmissibility for a given boundary segment.
      */
     Scalar transmissibilityBoundary(unsigned elemIdx, unsigned boundaryFaceIdx) const
-    { return transBoundary_.at(std::make_pair(elemIdx, boundaryFaceIdx)); }
+    {
+        assert(boundaryOffsets_[elemIdx] + boundaryFaceIdx < boundaryOffsets_[elemIdx + 1]);
+        return transBoundary_[boundaryOffsets_[elemIdx] + boundaryFaceIdx];
+    }
 
     /*!
      * \brief Return the thermal "half transmissibility" for the intersection between two
@@ -432,34 +336,324 @@ public:
      * cell and the center of the intersection.
      */
     Scalar thermalHalfTrans(unsigned insideElemIdx, unsigned outsideElemIdx) const
-    { return thermalHalfTrans_->at(directionalIsId_(insideElemIdx, outsideElemIdx)); }
+    {
+        const int faceIdx = faceIndex(insideElemIdx, outsideElemIdx);
+        if (faceIdx < 0)
+            throw std::out_of_range("The elements "+std::to_string(insideElemIdx)+" and "
+                                    +std::to_string(outsideElemIdx)+" do not share a face");
+
+        return (*thermalHalfTrans_)[directionalFaceIndex_(faceIdx, insideElemIdx, outsideElemIdx)];
+    }
 
     Scalar thermalHalfTransBoundary(unsigned insideElemIdx, unsigned boundaryFaceIdx) const
-    { return thermalHalfTransBoundary_.at(std::make_pair(insideElemIdx, boundaryFaceIdx)); }
+    {
+        assert(boundaryOffsets_[insideElemIdx] + boundaryFaceIdx < boundaryOffsets_[insideElemIdx + 1]);
+        return thermalHalfTransBoundary_[boundaryOffsets_[insideElemIdx] + boundaryFaceIdx];
+    }
 
 private:
 
+    // compute the transmissibilities of all intersections of an element. the
+    // transmissibility of a face between two elements is computed by the element with
+    // the smaller index.
+    void updateElementTransmissibilities_(const Element& elem,
+                                          const ElementMapper& elemMapper,
+                                          const std::array<std::vector<DimVector>, dimWorld>& axisCentroids,
+                                          const std::vector<double>& ntg)
+    {
+        const auto& gridView = vanguard_.gridView();
+        const auto& cartMapper = vanguard_.cartesianIndexMapper();
+        const auto& eclState = vanguard_.eclState();
+        const auto& eclGrid = eclState.getInputGrid();
+        const auto& cartDims = cartMapper.cartesianDimensions();
+        const auto& transMult = eclState.getTransMult();
+        unsigned elemIdx = elemMapper.index(elem);
+
+        auto isIt = gridView.ibegin(elem);
+        const auto& isEndIt = gridView.iend(elem);
+        unsigned boundaryIsIdx = 0;
+        for (; isIt != isEndIt; ++ isIt) {
+            // store intersection, this might be costly
+            const auto& intersection = *isIt;
+
+            // deal with grid boundaries
+            if (intersection.boundary()) {
+                // compute the transmissibilty for the boundary intersection
+                const auto& geometry = intersection.geometry();
+                const auto& faceCenterInside = geometry.center();
+
+                auto faceAreaNormal = intersection.centerUnitOuterNormal();
+                faceAreaNormal *= geometry.volume();
+
+                Scalar transBoundaryIs;
+                computeHalfTrans_(transBoundaryIs,
+                                  faceAreaNormal,
+                                  intersection.indexInInside(),
+                                  distanceVector_(faceCenterInside,
+                                                  intersection.indexInInside(),
+                                                  elemIdx,
+                                                  axisCentroids),
+                                  permeability_[elemIdx]);
+
+                // normally there would be two half-transmissibilities that would be
+                // averaged. on the grid boundary there only is the half
+                // transmissibility of the interior element.
+                transBoundary_[boundaryOffsets_[elemIdx] + boundaryIsIdx] = transBoundaryIs;
+
+                // for boundary intersections we also need to compute the thermal
+                // half transmissibilities
+                if (enableEnergy) {
+                    const auto& n = intersection.centerUnitOuterNormal();
+                    const auto& inPos = elem.geometry().center();
+                    const auto& outPos = intersection.geometry().center();
+                    const auto& d = outPos - inPos;
+
+                    // eWoms expects fluxes to be area specific, i.e. we must *not*
+                    // the transmissibility with the face area here
+                    Scalar thermalHalfTrans = std::abs(n*d)/(d*d);
+
+                    thermalHalfTransBoundary_[boundaryOffsets_[elemIdx] + boundaryIsIdx] =
+                        thermalHalfTrans;
+                }
+
+                ++ boundaryIsIdx;
+                continue;
+            }
+
+            if (!intersection.neighbor())
+                // elements can be on process boundaries, i.e. they are not on the
+                // domain boundary yet they don't have neighbors.
+                continue;
+
+            const auto& outsideElem = intersection.outside();
+            unsigned outsideElemIdx = elemMapper.index(outsideElem);
+            const int faceIdx = faceIndex(elemIdx, outsideElemIdx);
+            assert(faceIdx >= 0);
+
+            // update the "thermal half transmissibility" for the intersection
+            if (enableEnergy) {
+                const auto& n = intersection.centerUnitOuterNormal();
+                Scalar A = intersection.geometry().volume();
+
+                const auto& inPos = elem.geometry().center();
+                const auto& outPos = intersection.geometry().center();
+                const auto& d = outPos - inPos;
+
+                (*thermalHalfTrans_)[directionalFaceIndex_(faceIdx, elemIdx, outsideElemIdx)] =
+                    A * (n*d)/(d*d);
+            }
+
+            // we only need to calculate a face's transmissibility
+            // once...
+            if (elemIdx > outsideElemIdx)
+                continue;
+
+            unsigned insideCartElemIdx = cartMapper.cartesianIndex(elemIdx);
+            unsigned outsideCartElemIdx = cartMapper.cartesianIndex(outsideElemIdx);
+
+            // local indices of the faces of the inside and
+            // outside elements which contain the intersection
+            int insideFaceIdx  = intersection.indexInInside();
+            int outsideFaceIdx = intersection.indexInOutside();
+
+            if (insideFaceIdx == -1) {
+                // NNC. Set zero transmissibility, as it will be
+                // *added to* by applyNncToGridTrans_() later.
+                assert(outsideFaceIdx == -1);
+                trans_[faceIdx] = 0.0;
+                continue;
+            }
+
+            DimVector faceCenterInside;
+            DimVector faceCenterOutside;
+            DimVector faceAreaNormal;
+
+            typename std::is_same<Grid, Dune::CpGrid>::type isCpGrid;
+            computeFaceProperties(intersection,
+                                  elemIdx,
+                                  insideFaceIdx,
+                                  outsideElemIdx,
+                                  outsideFaceIdx,
+                                  faceCenterInside,
+                                  faceCenterOutside,
+                                  faceAreaNormal,
+                                  isCpGrid);
+
+            Scalar halfTrans1;
+            Scalar halfTrans2;
+
+            computeHalfTrans_(halfTrans1,
+                              faceAreaNormal,
+                              insideFaceIdx,
+                              distanceVector_(faceCenterInside,
+                                              intersection.indexInInside(),
+                                              elemIdx,
+                                              axisCentroids),
+                              permeability_[elemIdx]);
+            computeHalfTrans_(halfTrans2,
+                              faceAreaNormal,
+                              outsideFaceIdx,
+                              distanceVector_(faceCenterOutside,
+                                              intersection.indexInOutside(),
+                                              outsideElemIdx,
+                                              axisCentroids),
+                              permeability_[outsideElemIdx]);
+
+            applyNtg_(halfTrans1, insideFaceIdx, insideCartElemIdx, ntg);
+            applyNtg_(halfTrans2, outsideFaceIdx, outsideCartElemIdx, ntg);
+
+            // convert half transmissibilities to full face
+            // transmissibilities using the harmonic mean
+            Scalar trans;
+            if (std::abs(halfTrans1) < 1e-30 || std::abs(halfTrans2) < 1e-30)
+                // avoid division by zero
+                trans = 0.0;
+            else
+                trans = 1.0 / (1.0/halfTrans1 + 1.0/halfTrans2);
+
+            // apply the full face transmissibility multipliers
+            // for the inside ...
+
+            // The MULTZ needs special case if the option is ALL
+            // Then the smallest multiplier is applied.
+            // Default is to apply the top and bottom multiplier
+            bool useSmallestMultiplier = eclGrid.getMultzOption() == Opm::PinchMode::ModeEnum::ALL;
+            if (useSmallestMultiplier)
+                applyAllZMultipliers_(trans, insideFaceIdx, insideCartElemIdx, outsideCartElemIdx, transMult, cartDims);
+            else
+                applyMultipliers_(trans, insideFaceIdx, insideCartElemIdx, transMult);
+            // ... and outside elements
+            applyMultipliers_(trans, outsideFaceIdx, outsideCartElemIdx, transMult);
+
+            // apply the region multipliers (cf. the MULTREGT keyword)
+            Opm::FaceDir::DirEnum faceDir;
+            switch (insideFaceIdx) {
+            case 0:
+            case 1:
+                faceDir = Opm::FaceDir::XPlus;
+                break;
+
+            case 2:
+            case 3:
+                faceDir = Opm::FaceDir::YPlus;
+                break;
+
+            case 4:
+            case 5:
+                faceDir = Opm::FaceDir::ZPlus;
+                break;
+
+            default:
+                throw std::logic_error("Could not determine a face direction");
+            }
+
+            trans *= transMult.getRegionMultiplier(insideCartElemIdx,
+                                                   outsideCartElemIdx,
+                                                   faceDir);
+
+            trans_[faceIdx] = trans;
+        }
+    }
+
     void removeSmallNonCartesianTransmissibilities_()
     {
         const auto& cartMapper = vanguard_.cartesianIndexMapper();
         const auto& cartDims = cartMapper.cartesianDimensions();
-        for (auto&& trans: trans_) {
-            if (trans.second < transmissibilityThreshold_) {
-                const auto& id = trans.first;
-                const auto& elements = isIdReverse_(id);
-                int gc1 = std::min(cartMapper.cartesianIndex(elements.first), cartMapper.cartesianIndex(elements.second));
-                int gc2 = std::max(cartMapper.cartesianIndex(elements.first), cartMapper.cartesianIndex(elements.second));
+        const unsigned numElements = faceOffsets_.size() - 1;
+        for (unsigned elemIdx = 0; elemIdx < numElements; ++elemIdx) {
+            for (unsigned faceIdx = faceOffsets_[elemIdx]; faceIdx < faceOffsets_[elemIdx + 1]; ++faceIdx) {
+                if (trans_[faceIdx] >= transmissibilityThreshold_)
+                    continue;
+
+                const unsigned neighborIdx = faceNeighbors_[faceIdx];
+                int gc1 = std::min(cartMapper.cartesianIndex(elemIdx), cartMapper.cartesianIndex(neighborIdx));
+                int gc2 = std::max(cartMapper.cartesianIndex(elemIdx), cartMapper.cartesianIndex(neighborIdx));
 
                 // only adjust the NNCs
                 if (gc2 - gc1 == 1 || gc2 - gc1 == cartDims[0] || gc2 - gc1 == cartDims[0]*cartDims[1])
                     continue;
 
                 //remove transmissibilities less than the threshold (by default 1e-6 in the deck's unit system)
-                trans.second = 0.0;
+                trans_[faceIdx] = 0.0;
+            }
+        }
+    }
+
+    // determine the faces between elements and the boundary intersections of all
+    // elements. the faces between elements are stored in compressed sparse row format:
+    // the row of a face is given by the element with the smaller index, its column by
+    // the one with the larger index.
+    void updateFaceTopology_(const ElementMapper& elemMapper)
+    {
+        const auto& gridView = vanguard_.gridView();
+        const unsigned numElements = elemMapper.size();
+
+        faceOffsets_.assign(numElements + 1, 0);
+        boundaryOffsets_.assign(numElements + 1, 0);
+
+        // count the neighbors with a larger index and the boundary intersections of
+        // each element
+        auto elemIt = gridView.template begin</*codim=*/ 0>();
+        const auto& elemEndIt = gridView.template end</*codim=*/ 0>();
+        for (; elemIt != elemEndIt; ++elemIt) {
+            const auto& elem = *elemIt;
+            unsigned elemIdx = elemMapper.index(elem);
+
+            auto isIt = gridView.ibegin(elem);
+            const auto& isEndIt = gridView.iend(elem);
+            for (; isIt != isEndIt; ++ isIt) {
+                const auto& intersection = *isIt;
+                if (intersection.boundary())
+                    ++ boundaryOffsets_[elemIdx + 1];
+                else if (intersection.neighbor() && elemMapper.index(intersection.outside()) > elemIdx)
+                    ++ faceOffsets_[elemIdx + 1];
             }
         }
+        std::partial_sum(faceOffsets_.begin(), faceOffsets_.end(), faceOffsets_.begin());
+        std::partial_sum(boundaryOffsets_.begin(), boundaryOffsets_.end(), boundaryOffsets_.begin());
+
+        // collect the neighbors
+        faceNeighbors_.resize(faceOffsets_.back());
+        std::vector<unsigned> rowPos(faceOffsets_.begin(), faceOffsets_.end() - 1);
+        elemIt = gridView.template begin</*codim=*/ 0>();
+        for (; elemIt != elemEndIt; ++elemIt) {
+            const auto& elem = *elemIt;
+            unsigned elemIdx = elemMapper.index(elem);
+
+            auto isIt = gridView.ibegin(elem);
+            const auto& isEndIt = gridView.iend(elem);
+            for (; isIt != isEndIt; ++ isIt) {
+                const auto& intersection = *isIt;
+                if (intersection.boundary() || !intersection.neighbor())
+                    continue;
+
+                unsigned outsideElemIdx = elemMapper.index(intersection.outside());
+                if (outsideElemIdx > elemIdx)
+                    faceNeighbors_[rowPos[elemIdx]++] = outsideElemIdx;
+            }
+        }
+
+        // sort the neighbors of each element and merge multiple intersections between
+        // the same pair of elements into a single face
+        unsigned numFaces = 0;
+        for (unsigned elemIdx = 0; elemIdx < numElements; ++elemIdx) {
+            auto rowBegin = faceNeighbors_.begin() + faceOffsets_[elemIdx];
+            auto rowEnd = faceNeighbors_.begin() + faceOffsets_[elemIdx + 1];
+            std::sort(rowBegin, rowEnd);
+            rowEnd = std::unique(rowBegin, rowEnd);
+
+            faceOffsets_[elemIdx] = numFaces;
+            numFaces = std::copy(rowBegin, rowEnd, faceNeighbors_.begin() + numFaces) - faceNeighbors_.begin();
+        }
+        faceOffsets_[numElements] = numFaces;
+        faceNeighbors_.resize(numFaces);
+        faceNeighbors_.shrink_to_fit();
     }
 
+    // the thermal half transmissibilities are stored per face and direction
+    unsigned directionalFaceIndex_(unsigned faceIdx, unsigned insideElemIdx, unsigned outsideElemIdx) const
+    { return 2*faceIdx + (insideElemIdx > outsideElemIdx ? 1 : 0); }
+
     void applyAllZMultipliers_(Scalar& trans,
                                unsigned insideFaceIdx,
                                unsigned insideCartElemIdx,
@@ -523,7 +717,8 @@ private:
                 if (c1 > c2)
                     continue; // we only need to handle each connection once, thank you.
 
-                auto isId = isId_(c1, c2);
+                const int faceIdx = faceIndex(c1, c2);
+                assert(faceIdx >= 0);
 
                 int gc1 = std::min(cartMapper.cartesianIndex(c1), cartMapper.cartesianIndex(c2));
                 int gc2 = std::max(cartMapper.cartesianIndex(c1), cartMapper.cartesianIndex(c2));
@@ -531,26 +726,26 @@ private:
                 if (gc2 - gc1 == 1) {
                     if (inputTranx.deckAssigned())
                         // set simulator internal transmissibilities to values from inputTranx
-                        trans_[isId] = inputTranx.iget(gc1);
+                        trans_[faceIdx] = inputTranx.iget(gc1);
                     else
                         // Scale transmissibilities with scale factor from inputTranx
-                        trans_[isId] *= inputTranx.iget(gc1);
+                        trans_[faceIdx] *= inputTranx.iget(gc1);
                 }
                 else if (gc2 - gc1 == cartDims[0]) {
                     if (inputTrany.deckAssigned())
                         // set simulator internal transmissibilities to values from inputTrany
-                        trans_[isId] = inputTrany.iget(gc1);
+                        trans_[faceIdx] = inputTrany.iget(gc1);
                     else
                         // Scale transmissibilities with scale factor from inputTrany
-                        trans_[isId] *= inputTrany.iget(gc1);
+                        trans_[faceIdx] *= inputTrany.iget(gc1);
                 }
                 else if (gc2 - gc1 == cartDims[0]*cartDims[1]) {
                     if (inputTranz.deckAssigned())
                         // set simulator internal transmissibilities to values from inputTranz
-                        trans_[isId] = inputTranz.iget(gc1);
+                        trans_[faceIdx] = inputTranz.iget(gc1);
                     else
                         // Scale transmissibilities with scale factor from inputTranz
-                        trans_[isId] *= inputTranz.iget(gc1);
+                        trans_[faceIdx] *= inputTranz.iget(gc1);
                 }
                 //else.. We don't support modification of NNC at the moment.
             }
@@ -643,9 +838,9 @@ private:
                 continue;
             }
 
-            auto candidate = trans_.find(isId_(low, high));
+            const int faceIdx = faceIndex(low, high);
 
-            if (candidate == trans_.end())
+            if (faceIdx < 0)
                 // This NNC is not resembled by the grid. Save it for later
                 // processing with local cell values
                 unprocessedNnc.push_back({c1, c2, nncEntry.trans});
@@ -653,7 +848,7 @@ private:
                 // NNC is represented by the grid and might be a neighboring connection
                 // In this case the transmissibilty is added to the value already
                 // set or computed.
-                candidate->second += nncEntry.trans;
+                trans_[faceIdx] += nncEntry.trans;
                 processedNnc.push_back({c1, c2, nncEntry.trans});
             }
         }
@@ -680,8 +875,8 @@ private:
             if (low > high)
                 std::swap(low, high);
 
-            auto candidate = trans_.find(isId_(low, high));
-            if (candidate == trans_.end()) {
+            const int faceIdx = (low < 0 || high < 0) ? -1 : faceIndex(low, high);
+            if (faceIdx < 0) {
                 std::ostringstream sstr;
                 sstr << "Cannot edit NNC from " << c1 << " to " << c2
                      << " as it does not exist";
@@ -691,7 +886,7 @@ private:
             else {
                 // NNC exists
                 while (nnc!= end && c1==nnc->cell1 && c2==nnc->cell2) {
-                    candidate->second *= nnc->trans;
+                    trans_[faceIdx] *= nnc->trans;
                     ++nnc;
                 }
             }
@@ -734,30 +929,6 @@ private:
                                    "(The PERM{X,Y,Z} keywords are missing)");
     }
 
-    std::uint64_t isId_(std::uint32_t elemIdx1, std::uint32_t elemIdx2) const
-    {
-        std::uint32_t elemAIdx = std::min(elemIdx1, elemIdx2);
-        std::uint64_t elemBIdx = std::max(elemIdx1, elemIdx2);
-
-        return (elemBIdx<<elemIdxShift) + elemAIdx;
-    }
-
-    std::pair<std::uint32_t, std::uint32_t> isIdReverse_(const std::uint64_t& id) const
-    {
-        // Assigning an unsigned integer to a narrower type discards the most significant bits.
-        // See "The C programming language", section A.6.2.
-        // NOTE that the ordering of element A and B may have changed
-        std::uint32_t elemAIdx = id;
-        std::uint32_t elemBIdx = (id - elemAIdx) >> elemIdxShift;
-
-        return std::make_pair(elemAIdx, elemBIdx);
-    }
-
-    std::uint64_t directionalIsId_(std::uint32_t elemIdx1, std::uint32_t elemIdx2) const
-    {
-        return (std::uint64_t(elemIdx1)<<elemIdxShift) + elemIdx2;
-    }
-
     void computeHalfTrans_(Scalar& halfTrans,
                            const DimVector& areaNormal,
                            int faceIdx, // in the reference element that contains the intersection
@@ -903,11 +1074,19 @@ private:
     const Vanguard& vanguard_;
     Scalar transmissibilityThreshold_;
     std::vector<DimMatrix> permeability_;
-    std::unordered_map<std::uint64_t, Scalar> trans_;
-    std::map<std::pair<unsigned, unsigned>, Scalar> transBoundary_;
-    std::map<std::pair<unsigned, unsigned>, Scalar> thermalHalfTransBoundary_;
-    Opm::ConditionalStorage<enableEnergy,
-                            std::unordered_map<std::uint64_t, Scalar> > thermalHalfTrans_;
+
+    // the faces between elements in compressed sparse row format and their
+    // transmissibilities
+    std::vector<unsigned> faceOffsets_;
+    std::vector<unsigned> faceNeighbors_;
+    std::vector<Scalar> trans_;
+
+    // the offsets of the boundary intersections of each element and their
+    // transmissibilities
+    std::vector<unsigned> boundaryOffsets_;
+    std::vector<Scalar> transBoundary_;
+    std::vector<Scalar> thermalHalfTransBoundary_;
+    Opm::ConditionalStorage<enableEnergy, std::vector<Scalar> > thermalHalfTrans_;
 };
 
 } // namespace Ewoms
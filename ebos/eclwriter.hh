@@ -35,6 +35,7 @@
 #include <ewoms/disc/ecfv/ecfvdiscretization.hh>
 #include <ewoms/io/baseoutputwriter.hh>
 #include <ewoms/parallel/tasklets.hh>
+#include <ewoms/parallel/threadedentityiterator.hh>
 
 #include <ebos/nncsorter.hpp>
 
@@ -42,6 +43,8 @@
 #include <opm/output/eclipse/RestartValue.hpp>
 #include <opm/parser/eclipse/Units/UnitSystem.hpp>
 
+#include <opm/simulators/utils/RestartSegments.hpp>
+
 #include <opm/grid/GridHelpers.hpp>
 #include <opm/grid/utility/cartesianToCompressed.hpp>
 
@@ -50,6 +53,7 @@
 
 #include <opm/common/OpmLog/OpmLog.hpp>
 
+#include <exception>
 #include <list>
 #include <utility>
 #include <string>
@@ -63,6 +67,7 @@ BEGIN_PROPERTIES
 NEW_PROP_TAG(EnableEclOutput);
 NEW_PROP_TAG(EnableAsyncEclOutput);
 NEW_PROP_TAG(EclOutputDoublePrecision);
+NEW_PROP_TAG(EclOutputDistributed);
 
 END_PROPERTIES
 
@@ -147,6 +152,7 @@ class EclWriter
     typedef typename GET_PROP_TYPE(TypeTag, Grid) Grid;
     typedef typename GET_PROP_TYPE(TypeTag, Scalar) Scalar;
     typedef typename GET_PROP_TYPE(TypeTag, ElementContext) ElementContext;
+    typedef typename GET_PROP_TYPE(TypeTag, IntensiveQuantities) IntensiveQuantities;
     typedef typename GET_PROP_TYPE(TypeTag, FluidSystem) FluidSystem;
     typedef typename GridView::template Codim<0>::Entity Element;
     typedef typename GridView::template Codim<0>::Iterator ElementIterator;
@@ -164,6 +170,11 @@ public:
 
         EWOMS_REGISTER_PARAM(TypeTag, bool, EnableAsyncEclOutput,
                              "Write the ECL-formated results in a non-blocking way (i.e., using a separate thread).");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EclOutputDistributed,
+                             "Let each process write the cell data of the restart output to its own segment file "
+                             "instead of collecting it on the I/O rank. The output directory must be on a file "
+                             "system which is shared by all processes and the segments need to be stitched "
+                             "together by Opm::stitchRestartSegments() after the simulation.");
     }
 
     // The Simulator object should preferably have been const - the
@@ -173,6 +184,7 @@ public:
         : simulator_(simulator)
         , collectToIORank_(simulator_.vanguard())
         , eclOutputModule_(simulator, collectToIORank_)
+        , outputPrepared_(false)
     {
         globalGrid_ = simulator_.vanguard().grid();
         globalGrid_.switchToGlobalView();
@@ -208,12 +220,74 @@ public:
         }
     }
 
+    /*!
+     * \brief Evaluate the output quantities of all elements for the current solution.
+     *
+     * The quantities needed by evalSummaryState() and writeOutput() are computed in a
+     * single sweep over the grid. If this method has not been called for the current
+     * solution, these methods call it themselves.
+     */
+    void prepareOutput(bool isSubStep)
+    {
+        outputPrepared_ = true;
+        preparedEpisodeIdx_ = simulator_.episodeIndex();
+        preparedTime_ = simulator_.time() + simulator_.timeStepSize();
+        preparedSubStep_ = isSubStep;
+
+        int reportStepNum = simulator_.episodeIndex() + 1;
+        const auto& gridView = simulator_.vanguard().gridView();
+        int numElements = gridView.size(/*codim=*/0);
+        bool log = collectToIORank_.isIORank();
+        eclOutputModule_.allocBuffers(numElements, reportStepNum, isSubStep, log);
+
+        // exceptions must not leave the parallel region, so the first one is stored
+        // and thrown again after all threads have finished.
+        std::exception_ptr exceptionPtr;
+        const auto& model = simulator_.model();
+        const auto& elemMapper = simulator_.problem().elementMapper();
+        Ewoms::ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            ElementContext elemCtx(simulator_);
+            ElementIterator elemIt = threadedElemIt.beginParallel();
+            for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
+                try {
+                    const Element& elem = *elemIt;
+                    unsigned globalDofIdx = elemMapper.index(elem);
+
+                    // use the cached intensive quantities if possible, else compute them
+                    const IntensiveQuantities* iq = model.cachedIntensiveQuantities(globalDofIdx, /*timeIdx=*/0);
+                    if (!iq) {
+                        elemCtx.updatePrimaryStencil(elem);
+                        elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+                        iq = &elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
+                    }
+
+                    eclOutputModule_.processElement(globalDofIdx, *iq);
+                }
+                catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                    if (!exceptionPtr)
+                        exceptionPtr = std::current_exception();
+                }
+            }
+        }
+        if (exceptionPtr)
+            std::rethrow_exception(exceptionPtr);
+    }
+
     /*!
      * \brief collect and pass data and pass it to eclIO writer
      */
 
     void evalSummaryState(bool isSubStep)
     {
+        prepareOutputIfNeeded_(isSubStep);
+
         int reportStepNum = simulator_.episodeIndex() + 1;
         /*
           The summary data is not evaluated for timestep 0, that is
@@ -244,21 +318,6 @@ public:
 
         Opm::data::Wells localWellData = simulator_.problem().wellModel().wellData();
 
-        const auto& gridView = simulator_.vanguard().gridView();
-        int numElements = gridView.size(/*codim=*/0);
-        bool log = collectToIORank_.isIORank();
-        eclOutputModule_.allocBuffers(numElements, reportStepNum, isSubStep, log);
-
-        ElementContext elemCtx(simulator_);
-        ElementIterator elemIt = gridView.template begin</*codim=*/0>();
-        const ElementIterator& elemEndIt = gridView.template end</*codim=*/0>();
-        for (; elemIt != elemEndIt; ++elemIt) {
-            const Element& elem = *elemIt;
-            elemCtx.updatePrimaryStencil(elem);
-            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-            eclOutputModule_.processElement(elemCtx);
-        }
-
         if (collectToIORank_.isParallel())
             collectToIORank_.collect({}, eclOutputModule_.getBlockData(), localWellData);
 
@@ -312,6 +371,8 @@ public:
 
     void writeOutput(bool isSubStep)
     {
+        prepareOutputIfNeeded_(isSubStep);
+
         Scalar curTime = simulator_.time() + simulator_.timeStepSize();
         Scalar nextStepSize = simulator_.problem().nextTimeStepSize();
 
@@ -319,20 +380,6 @@ public:
         Opm::data::Wells localWellData = simulator_.problem().wellModel().wellData();
 
         int reportStepNum = simulator_.episodeIndex() + 1;
-        const auto& gridView = simulator_.vanguard().gridView();
-        int numElements = gridView.size(/*codim=*/0);
-        bool log = collectToIORank_.isIORank();
-        eclOutputModule_.allocBuffers(numElements, reportStepNum, isSubStep, log);
-
-        ElementContext elemCtx(simulator_);
-        ElementIterator elemIt = gridView.template begin</*codim=*/0>();
-        const ElementIterator& elemEndIt = gridView.template end</*codim=*/0>();
-        for (; elemIt != elemEndIt; ++elemIt) {
-            const Element& elem = *elemIt;
-            elemCtx.updatePrimaryStencil(elem);
-            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-            eclOutputModule_.processElement(elemCtx);
-        }
         eclOutputModule_.outputErrorLog();
 
         // collect all data to I/O rank and assign to sol
@@ -344,9 +391,20 @@ public:
         if (!isSubStep)
             eclOutputModule_.addRftDataToWells(localWellData, reportStepNum);
 
-        if (collectToIORank_.isParallel())
-            collectToIORank_.collect(localCellData, eclOutputModule_.getBlockData(), localWellData);
+        // with distributed output, every process writes its part of the cell data
+        // itself and only the well and block data is collected on the I/O rank. the
+        // restart file then only contains the well data; the cell data is left in
+        // the segment files for an offline stitch step.
+        const bool distributedOutput =
+            collectToIORank_.isParallel() && EWOMS_GET_PARAM(TypeTag, bool, EclOutputDistributed);
+        if (distributedOutput) {
+            if (!localCellData.empty())
+                writeRestartSegment_(reportStepNum, localCellData);
 
+            collectToIORank_.collect({}, eclOutputModule_.getBlockData(), localWellData);
+        }
+        else if (collectToIORank_.isParallel())
+            collectToIORank_.collect(localCellData, eclOutputModule_.getBlockData(), localWellData);
 
         if (collectToIORank_.isIORank()) {
             const auto& eclState = simulator_.vanguard().eclState();
@@ -458,6 +516,64 @@ private:
     static bool enableEclOutput_()
     { return EWOMS_GET_PARAM(TypeTag, bool, EnableEclOutput); }
 
+    // evaluate the output quantities unless prepareOutput() has already been called
+    // for the current time step
+    void prepareOutputIfNeeded_(bool isSubStep)
+    {
+        if (outputPrepared_
+            && preparedEpisodeIdx_ == simulator_.episodeIndex()
+            && preparedTime_ == simulator_.time() + simulator_.timeStepSize()
+            && preparedSubStep_ == isSubStep)
+            return;
+
+        prepareOutput(isSubStep);
+    }
+
+    // write the cell data of the interior cells of this process together with their
+    // global indices. every cell is interior on exactly one process, so the segments
+    // of all processes can be stitched together using Opm::stitchRestartSegments()
+    // without relying on the values of the overlap cells.
+    void writeRestartSegment_(int reportStepNum, const Opm::data::Solution& localCellData)
+    {
+        const auto& gridView = simulator_.vanguard().gridView();
+        const auto& elemMapper = simulator_.problem().elementMapper();
+        std::vector<unsigned> interiorElements;
+        std::vector<int> globalIndex;
+        auto elemIt = gridView.template begin</*codim=*/0>();
+        const auto& elemEndIt = gridView.template end</*codim=*/0>();
+        for (; elemIt != elemEndIt; ++elemIt) {
+            const Element& elem = *elemIt;
+            if (elem.partitionType() != Dune::InteriorEntity)
+                continue;
+
+            const unsigned elemIdx = elemMapper.index(elem);
+            interiorElements.push_back(elemIdx);
+            globalIndex.push_back(collectToIORank_.localIdxToGlobalIdx(elemIdx));
+        }
+
+        Opm::data::Solution interiorCellData;
+        for (const auto& entry : localCellData) {
+            std::vector<double> values(interiorElements.size());
+            for (std::size_t cellIdx = 0; cellIdx < interiorElements.size(); ++cellIdx)
+                values[cellIdx] = entry.second.data[interiorElements[cellIdx]];
+            interiorCellData.insert(entry.first, entry.second.dim, std::move(values), entry.second.target);
+        }
+
+        const auto& ioConfig = eclState().getIOConfig();
+        const auto& comm = gridView.comm();
+        const int numGlobalCells = globalGrid_.size(/*codim=*/0);
+        Opm::writeRestartSegment(Opm::restartSegmentFileName(ioConfig.getOutputDir(),
+                                                             ioConfig.getBaseName(),
+                                                             reportStepNum,
+                                                             comm.rank()),
+                                 reportStepNum,
+                                 comm.rank(),
+                                 comm.size(),
+                                 numGlobalCells,
+                                 globalIndex,
+                                 interiorCellData);
+    }
+
     Opm::data::Solution computeTrans_(const std::unordered_map<int,int>& cartesianToActive) const
     {
         const auto& cartMapper = simulator_.vanguard().cartesianIndexMapper();
@@ -709,6 +825,12 @@ private:
     std::unique_ptr<TaskletRunner> taskletRunner_;
     Scalar restartTimeStepSize_;
 
+    // the time step for which prepareOutput() was called last
+    bool outputPrepared_;
+    int preparedEpisodeIdx_;
+    Scalar preparedTime_;
+    bool preparedSubStep_;
+
 
 };
 } // namespace Ewoms
@@ -37,6 +37,7 @@ namespace Opm
         }
 
         roots_.push_back(createGroupWellsGroup(fieldGroup, timeStep, phaseUsage));
+        indexNode(roots_.back().get());
     }
 
     void WellCollection::addGroup(const Group& groupChild, std::string parent_name,
@@ -67,6 +68,7 @@ namespace Opm
         }
         parent_as_group->addChild(child);
         child->setParent(parent);
+        indexNode(child.get());
     }
 
     void WellCollection::addWell(const Well2& wellChild, const SummaryState& summaryState, size_t timeStep, const PhaseUsage& phaseUsage) {
@@ -88,7 +90,8 @@ namespace Opm
         }
         parent_as_group->addChild(child);
 
-        leaf_nodes_.push_back(static_cast<WellNode*>(child.get()));
+        addLeafNode(static_cast<WellNode*>(child.get()));
+        indexNode(child.get());
 
         child->setParent(parent);
     }
@@ -99,42 +102,50 @@ namespace Opm
 
     WellsGroupInterface* WellCollection::findNode(const std::string& name)
     {
-
-        for (size_t i = 0; i < roots_.size(); i++) {
-            WellsGroupInterface* result = roots_[i]->findGroup(name);
-            if (result) {
-                return result;
-            }
+        const auto node = node_index_.find(name);
+        if (node == node_index_.end()) {
+            return NULL;
         }
-        return NULL;
+        return node->second;
     }
 
     const WellsGroupInterface* WellCollection::findNode(const std::string& name) const
     {
-
-        for (size_t i = 0; i < roots_.size(); i++) {
-            WellsGroupInterface* result = roots_[i]->findGroup(name);
-            if (result) {
-                return result;
-            }
+        const auto node = node_index_.find(name);
+        if (node == node_index_.end()) {
+            return NULL;
         }
-        return NULL;
+        return node->second;
     }
 
 
     WellNode& WellCollection::findWellNode(const std::string& name) const
     {
-        auto well_node = std::find_if(leaf_nodes_.begin(), leaf_nodes_.end(),
-                    [&] ( WellNode* w) {
-                    return w->name() == name;
-                    });
+        const auto well_node = well_node_index_.find(name);
 
         // Does not find the well
-        if (well_node == leaf_nodes_.end()) {
+        if (well_node == well_node_index_.end()) {
             OPM_THROW(std::runtime_error, "Could not find well " << name << " in the well collection!\n");
         }
 
-        return *(*well_node);
+        return *(well_node->second);
+    }
+
+    void WellCollection::indexNode(WellsGroupInterface* node)
+    {
+        // keep the first node with a given name, like the search through the trees did
+        node_index_.emplace(node->name(), node);
+        if (!node->isLeafNode()) {
+            for (const auto& child : static_cast<WellsGroup*>(node)->children()) {
+                indexNode(child.get());
+            }
+        }
+    }
+
+    void WellCollection::addLeafNode(WellNode* node)
+    {
+        leaf_nodes_.push_back(node);
+        well_node_index_.emplace(node->name(), node);
     }
 
     /// Adds the child to the collection
@@ -152,8 +163,9 @@ namespace Opm
         assert(!parent->isLeafNode());
         static_cast<WellsGroup*>(parent)->addChild(child_node);
         if (child_node->isLeafNode()) {
-            leaf_nodes_.push_back(static_cast<WellNode*>(child_node.get()));
+            addLeafNode(static_cast<WellNode*>(child_node.get()));
         }
+        indexNode(child_node.get());
 
     }
 
@@ -163,8 +175,9 @@ namespace Opm
     {
         roots_.push_back(child_node);
         if (child_node->isLeafNode()) {
-            leaf_nodes_.push_back(static_cast<WellNode*> (child_node.get()));
+            addLeafNode(static_cast<WellNode*> (child_node.get()));
         }
+        indexNode(child_node.get());
     }
 
     bool WellCollection::conditionsMet(const std::vector<double>& well_bhp,
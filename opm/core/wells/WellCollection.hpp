@@ -21,6 +21,8 @@
 
 #include <vector>
 #include <memory>
+#include <string>
+#include <unordered_map>
 
 #include <opm/core/wells/WellsGroup.hpp>
 #include <opm/grid/UnstructuredGrid.h>
@@ -165,6 +167,18 @@ namespace Opm
         // This will be used to traverse the bottom nodes.
         std::vector<WellNode*> leaf_nodes_;
 
+        // name -> node lookup for all the nodes of the forest, and for the leaf
+        // nodes, so that findNode() and findWellNode() do not need to search
+        // through the trees.
+        std::unordered_map<std::string, WellsGroupInterface*> node_index_;
+        std::unordered_map<std::string, WellNode*> well_node_index_;
+
+        // Adds the node and all its descendants to node_index_.
+        void indexNode(WellsGroupInterface* node);
+
+        // Adds the node to leaf_nodes_ and well_node_index_.
+        void addLeafNode(WellNode* node);
+
         bool having_vrep_groups_ = false;
 
         bool group_control_active_ = false;
@@ -62,6 +62,13 @@ namespace Opm
       }
     }
 
+    template <class Serializer>
+    void checkpoint(Serializer& serializer, const std::string& prefix)
+    {
+      Base::checkpoint(serializer, prefix);
+      serializer.value(prefix + "aquifer_pressure", aquifer_pressure_);
+    }
+
   protected:
     // Aquifer Fetkovich Specific Variables
     const Aquifetp::AQUFETP_data aqufetp_data_;
@@ -210,26 +217,14 @@ namespace Opm
       std::vector<Scalar> pw_aquifer;
       Scalar water_pressure_reservoir;
 
-      ElementContext elemCtx(Base::ebos_simulator_);
-      const auto& gridView = Base::ebos_simulator_.gridView();
-      auto elemIt = gridView.template begin</*codim=*/0>();
-      const auto& elemEndIt = gridView.template end</*codim=*/0>();
-      for (; elemIt != elemEndIt; ++elemIt) {
-        const auto& elem = *elemIt;
-        elemCtx.updatePrimaryStencil(elem);
-        size_t cellIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-        int idx = Base::cellToConnectionIdx_[cellIdx];
-        if (idx < 0)
-        continue;
-
-        elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-        const auto& iq0 = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
+      Base::forEachConnectedCell_([&](const int idx, const IntensiveQuantities& iq0)
+      {
         const auto& fs = iq0.fluidState();
 
         water_pressure_reservoir = fs.pressure(waterPhaseIdx).value();
         Base::rhow_[idx] = fs.density(waterPhaseIdx);
         pw_aquifer.push_back( (water_pressure_reservoir - Base::rhow_[idx].value()*Base::gravity_()*(Base::cell_depth_[idx] - aqufetp_data_.d0))*Base::alphai_[idx] );
-      }
+      });
 
       // We take the average of the calculated equilibrium pressures.
       Scalar aquifer_pres_avg = std::accumulate(pw_aquifer.begin(), pw_aquifer.end(), 0.)/pw_aquifer.size();
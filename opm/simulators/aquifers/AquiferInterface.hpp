@@ -34,6 +34,7 @@
 
 #include <vector>
 #include <algorithm>
+#include <string>
 #include <unordered_map>
 
 namespace Opm
@@ -81,23 +82,35 @@ namespace Opm
 
     void beginTimeStep()
     {
-      ElementContext elemCtx(ebos_simulator_);
-      auto elemIt = ebos_simulator_.gridView().template begin<0>();
-      const auto& elemEndIt = ebos_simulator_.gridView().template end<0>();
-      for (; elemIt != elemEndIt; ++elemIt) {
-        const auto& elem = *elemIt;
-
-        elemCtx.updatePrimaryStencil(elem);
-
-        int cellIdx = elemCtx.globalSpaceIndex(0, 0);
-        int idx = cellToConnectionIdx_[cellIdx];
-        if (idx < 0)
-        continue;
+      forEachConnectedCell_([this](const int idx, const IntensiveQuantities& iq)
+                            {
+                              pressure_previous_[idx] = Opm::getValue(iq.fluidState().pressure(waterPhaseIdx));
+                            });
+    }
 
-        elemCtx.updateIntensiveQuantities(0);
-        const auto& iq = elemCtx.intensiveQuantities(0, 0);
-        pressure_previous_[idx] = Opm::getValue(iq.fluidState().pressure(waterPhaseIdx));
+    // Write the state of the aquifer which evolves over the time steps to a
+    // checkpoint or read it from one, see CheckpointWriter.
+    template <class Serializer>
+    void checkpoint(Serializer& serializer, const std::string& prefix)
+    {
+      // the cumulative influx is stored with its derivatives because they
+      // enter the inflow rates of the following time steps
+      std::vector<Scalar> flux(numEq + 1);
+      flux[0] = W_flux_.value();
+      for (int eqIdx = 0; eqIdx < numEq; ++eqIdx) {
+        flux[eqIdx + 1] = W_flux_.derivative(eqIdx);
+      }
+      serializer.vector(prefix + "W_flux", flux);
+      W_flux_.setValue(flux[0]);
+      for (int eqIdx = 0; eqIdx < numEq; ++eqIdx) {
+        W_flux_.setDerivative(eqIdx, flux[eqIdx + 1]);
       }
+
+      // these are computed from the reservoir state at the beginning of the
+      // simulation, which the restored simulation does not start from
+      serializer.value(prefix + "pa0", pa0_);
+      serializer.value(prefix + "mu_w", mu_w_);
+      serializer.value(prefix + "Tc", Tc_);
     }
 
     template <class Context>
@@ -111,7 +124,7 @@ namespace Opm
 
       // We are dereferencing the value of IntensiveQuantities because cachedIntensiveQuantities return a const pointer to
       // IntensiveQuantities of that particular cell_id
-      const IntensiveQuantities intQuants = context.intensiveQuantities(spaceIdx, timeIdx);
+      const IntensiveQuantities& intQuants = context.intensiveQuantities(spaceIdx, timeIdx);
       // This is the pressure at td + dt
       updateCellPressure(pressure_current_,idx,intQuants);
       updateCellDensity(idx,intQuants);
@@ -133,6 +146,7 @@ namespace Opm
 
       // We next get our connections to the aquifer and initialize these quantities using the initialize_connections function
       initializeConnections(connection);
+      initConnectedCells_();
       calculateAquiferCondition();
       calculateAquiferConstants();
 
@@ -141,6 +155,57 @@ namespace Opm
       Qai_.resize(cell_idx_.size(), 0.0);
     }
 
+    // Collects the compressed indices of the cells connected to the aquifer,
+    // in the order in which they are visited by a sweep over the grid.
+    inline void initConnectedCells_()
+    {
+      connected_cells_.clear();
+      for (size_t cellIdx = 0; cellIdx < cellToConnectionIdx_.size(); ++cellIdx) {
+        if (cellToConnectionIdx_[cellIdx] >= 0)
+          connected_cells_.push_back(cellIdx);
+      }
+    }
+
+    // Calls func(idx, intQuants) for every cell connected to the aquifer, idx being
+    // the connection index of the cell. The cached intensive quantities of the
+    // connected cells are used if they are all available, so that the cost scales
+    // with the number of connections instead of the size of the grid.
+    template <class Functor>
+    void forEachConnectedCell_(Functor&& func) const
+    {
+      const auto& model = ebos_simulator_.model();
+      const bool all_cached = std::all_of(connected_cells_.begin(), connected_cells_.end(),
+                                          [&model](const unsigned cellIdx)
+                                          {
+                                            return model.cachedIntensiveQuantities(cellIdx, /*timeIdx=*/0) != nullptr;
+                                          });
+      if (all_cached) {
+        for (const unsigned cellIdx : connected_cells_) {
+          func(cellToConnectionIdx_[cellIdx], *model.cachedIntensiveQuantities(cellIdx, /*timeIdx=*/0));
+        }
+        return;
+      }
+
+      // The intensive quantities are not cached (yet), compute them from the
+      // primary variables of the connected cells.
+      ElementContext elemCtx(ebos_simulator_);
+      auto elemIt = ebos_simulator_.gridView().template begin</*codim=*/0>();
+      const auto& elemEndIt = ebos_simulator_.gridView().template end</*codim=*/0>();
+      for (; elemIt != elemEndIt; ++elemIt) {
+        const auto& elem = *elemIt;
+
+        elemCtx.updatePrimaryStencil(elem);
+
+        const int cellIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
+        const int idx = cellToConnectionIdx_[cellIdx];
+        if (idx < 0)
+          continue;
+
+        elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+        func(idx, elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0));
+      }
+    }
+
     inline void updateCellPressure(std::vector<Eval>& pressure_water, const int idx, const IntensiveQuantities& intQuants)
     {
       const auto& fs = intQuants.fluidState();
@@ -194,6 +259,8 @@ namespace Opm
     std::vector<size_t> cell_idx_;
     std::vector<Scalar> faceArea_connected_;
     std::vector<int> cellToConnectionIdx_;
+    // Compressed indices of the cells connected to the aquifer
+    std::vector<unsigned> connected_cells_;
     // Quantities at each grid id
     std::vector<Scalar> cell_depth_;
     std::vector<Scalar> pressure_previous_;
@@ -66,6 +66,11 @@ namespace Opm {
             template <class Restarter>
             void deserialize(Restarter& res);
 
+            // write the state of the aquifers to a binary checkpoint or
+            // read it from one, see CheckpointWriter.
+            template <class Serializer>
+            void checkpoint(Serializer& serializer);
+
         protected:
             // ---------      Types      ---------
             typedef typename GET_PROP_TYPE(TypeTag, ElementContext)      ElementContext;
@@ -124,6 +124,19 @@ namespace Opm {
         throw std::logic_error("BlackoilAquiferModel::deserialize() is not yet implemented");
     }
 
+    template<typename TypeTag>
+    template <class Serializer>
+    void
+    BlackoilAquiferModel<TypeTag>::checkpoint(Serializer& serializer)
+    {
+        for (size_t aquiferIdx = 0; aquiferIdx < aquifers_CarterTracy.size(); ++aquiferIdx) {
+            aquifers_CarterTracy[aquiferIdx].checkpoint(serializer, "aquifers/carter_tracy/" + std::to_string(aquiferIdx) + "/");
+        }
+        for (size_t aquiferIdx = 0; aquiferIdx < aquifers_Fetkovich.size(); ++aquiferIdx) {
+            aquifers_Fetkovich[aquiferIdx].checkpoint(serializer, "aquifers/fetkovich/" + std::to_string(aquiferIdx) + "/");
+        }
+    }
+
   // Initialize the aquifers in the deck
   template<typename TypeTag>
   void
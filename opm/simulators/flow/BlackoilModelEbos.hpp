@@ -26,6 +26,7 @@
 
 #include <ebos/eclproblem.hh>
 #include <ewoms/common/start.hh>
+#include <ewoms/parallel/threadedentityiterator.hh>
 
 #include <opm/simulators/timestepping/AdaptiveTimeSteppingEbos.hpp>
 
@@ -38,7 +39,9 @@
 
 #include <opm/grid/UnstructuredGrid.h>
 #include <opm/simulators/timestepping/SimulatorReport.hpp>
+#include <opm/simulators/utils/allReduceSumMax.hpp>
 #include <opm/simulators/linalg/ParallelIstlInformation.hpp>
+#include <opm/simulators/linalg/AdaptiveImplicitSystem.hpp>
 #include <opm/core/props/phaseUsageFromDeck.hpp>
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/common/Exceptions.hpp>
@@ -53,6 +56,9 @@
 #include <opm/common/data/SimulationDataContainer.hpp>
 
 #include <dune/istl/owneroverlapcopy.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/solvers.hh>
 #include <dune/common/parallel/collectivecommunication.hh>
 #include <dune/common/timer.hh>
 #include <dune/common/unused.hh>
@@ -62,6 +68,7 @@
 #include <iostream>
 #include <iomanip>
 #include <limits>
+#include <numeric>
 #include <vector>
 #include <algorithm>
 
@@ -107,7 +114,10 @@ namespace Opm {
 
         typedef typename GET_PROP_TYPE(TypeTag, Simulator)         Simulator;
         typedef typename GET_PROP_TYPE(TypeTag, Grid)              Grid;
+        typedef typename GET_PROP_TYPE(TypeTag, GridView)          GridView;
         typedef typename GET_PROP_TYPE(TypeTag, ElementContext)    ElementContext;
+        typedef typename GET_PROP_TYPE(TypeTag, IntensiveQuantities) IntensiveQuantities;
+        typedef typename GET_PROP_TYPE(TypeTag, ThreadManager)     ThreadManager;
         typedef typename GET_PROP_TYPE(TypeTag, SparseMatrixAdapter) SparseMatrixAdapter;
         typedef typename GET_PROP_TYPE(TypeTag, SolutionVector)    SolutionVector ;
         typedef typename GET_PROP_TYPE(TypeTag, PrimaryVariables)  PrimaryVariables ;
@@ -165,6 +175,10 @@ namespace Opm {
         , terminal_output_ (terminal_output)
         , current_relaxation_(1.0)
         , dx_old_(UgGridHelpers::numCells(grid_))
+        , active_set_linearizations_(0)
+        , active_set_stale_cache_(false)
+        , last_linearization_partial_(false)
+        , line_search_possible_(false)
         {
             // compute global sum of number of cells
             global_nc_ = detail::countGlobalCells(grid_);
@@ -232,6 +246,9 @@ namespace Opm {
                 residual_norms_history_.clear();
                 current_relaxation_ = 1.0;
                 dx_old_ = 0.0;
+                anderson_dx_.clear();
+                anderson_applied_.clear();
+                line_search_possible_ = false;
                 convergence_reports_.push_back({timer.reportStepNum(), timer.currentStepNum(), {}});
                 convergence_reports_.back().report.reserve(11);
             }
@@ -255,6 +272,19 @@ namespace Opm {
             // the step is not considered converged until at least minIter iterations is done
             {
                 auto convrep = getConvergence(timer, iteration,residual_norms);
+                if (param_.use_line_search_ && line_search_possible_) {
+                    report += lineSearch_(timer, iteration, residual_norms, convrep);
+                }
+                if (convrep.converged() && last_linearization_partial_) {
+                    // the residuals of the cells which were skipped by the partial
+                    // linearization are slightly outdated. convergence is only accepted
+                    // for a linearization of the whole reservoir.
+                    active_set_linearizations_ = param_.max_active_set_linearizations_;
+                    report += assembleReservoir(timer, iteration);
+                    report.total_linearizations += 1;
+                    residual_norms.clear();
+                    convrep = getConvergence(timer, iteration, residual_norms);
+                }
                 report.converged = convrep.converged()  && iteration > nonlinear_solver.minIter();;
                 ConvergenceReport::Severity severity = convrep.severityOfWorstFailure();
                 convergence_reports_.back().report.push_back(std::move(convrep));
@@ -275,6 +305,39 @@ namespace Opm {
             report.update_time += perfTimer.stop();
             residual_norms_history_.push_back(residual_norms);
             if (!report.converged) {
+                // first solve for the regions where the solution is still far from
+                // converged without touching the rest of the reservoir
+                if (param_.use_local_newton_ && !isParallel()) {
+                    bool localConverged = false;
+                    try {
+                        report += solveLocalDomains_(timer, iteration, localConverged);
+                    }
+                    catch (...) {
+                        failureReport_ += report;
+                        throw;
+                    }
+
+                    if (localConverged) {
+                        // the local updates removed all violations of the CNV criterion.
+                        // if this also satisfies the remaining criteria, the global
+                        // update is not required anymore. like above, convergence is only
+                        // accepted for a linearization of the whole reservoir.
+                        residual_norms.clear();
+                        auto convrep = getConvergence(timer, iteration, residual_norms);
+                        bool converged = convrep.converged() && !last_linearization_partial_
+                            && iteration > nonlinear_solver.minIter();
+                        if (wellModel().wellCollection().groupControlActive()) {
+                            converged = converged && wellModel().wellCollection().groupTargetConverged(wellModel().wellState().wellRates());
+                        }
+                        residual_norms_history_.back() = residual_norms;
+                        convergence_reports_.back().report.back() = std::move(convrep);
+                        if (converged) {
+                            report.converged = true;
+                            return report;
+                        }
+                    }
+                }
+
                 perfTimer.reset();
                 perfTimer.start();
                 report.total_newton_iterations = 1;
@@ -291,6 +354,11 @@ namespace Opm {
                 wellModel().linearize(ebosSimulator().model().linearizer().jacobian(),
                                       ebosSimulator().model().linearizer().residual());
 
+                // treat the quiescent cells implicitly in pressure and explicitly in
+                // all other primary variables
+                const bool adaptiveImplicit =
+                    param_.use_adaptive_implicit_ && prepareAdaptiveImplicitSystem_();
+
                 // Solve the linear system.
                 linear_solve_setup_time_ = 0.0;
                 try {
@@ -304,6 +372,10 @@ namespace Opm {
                     report.linear_solve_time += perfTimer.stop();
                     report.total_linear_iterations += linearIterationsLastSolve();
 
+                    if (adaptiveImplicit) {
+                        restoreAdaptiveImplicitResidual_();
+                    }
+
                     failureReport_ += report;
                     throw; // re-throw up
                 }
@@ -311,6 +383,15 @@ namespace Opm {
                 perfTimer.reset();
                 perfTimer.start();
 
+                if (adaptiveImplicit) {
+                    recoverAdaptiveImplicitUpdate_(x);
+                }
+
+                if (param_.use_anderson_acceleration_ && !isParallel()) {
+                    nonlinear_solver.accelerateNonlinearUpdate(x, anderson_dx_, anderson_applied_,
+                                                               param_.anderson_acceleration_depth_);
+                }
+
                 // handling well state update before oscillation treatment is a decision based
                 // on observation to avoid some big performance degeneration under some circumstances.
                 // there is no theorectical explanation which way is better for sure.
@@ -320,7 +401,10 @@ namespace Opm {
                     // Stabilize the nonlinear update.
                     bool isOscillate = false;
                     bool isStagnate = false;
-                    nonlinear_solver.detectOscillations(residual_norms_history_, iteration, isOscillate, isStagnate);
+                    // the history may have been restarted by the local iterations, so it
+                    // is not necessarily indexed by the Newton iteration
+                    const int lastIdx = static_cast<int>(residual_norms_history_.size()) - 1;
+                    nonlinear_solver.detectOscillations(residual_norms_history_, lastIdx, isOscillate, isStagnate);
                     if (isOscillate) {
                         current_relaxation_ -= nonlinear_solver.relaxIncrement();
                         current_relaxation_ = std::max(current_relaxation_, nonlinear_solver.relaxMax());
@@ -333,10 +417,23 @@ namespace Opm {
                     nonlinear_solver.stabilizeNonlinearUpdate(x, dx_old_, current_relaxation_);
                 }
 
+                const bool useAnderson = param_.use_anderson_acceleration_ && !isParallel();
+                if (param_.use_line_search_ || useAnderson) {
+                    line_search_solution_ = ebosSimulator_.model().solution(/*timeIdx=*/0);
+                }
+                if (param_.use_line_search_) {
+                    line_search_dx_ = x;
+                    line_search_possible_ = true;
+                }
+
                 // Apply the update, with considering model-dependent limitations and
                 // chopping of the update.
                 updateSolution(x);
 
+                if (useAnderson) {
+                    anderson_applied_.push_back(appliedUpdate_(line_search_solution_, x));
+                }
+
                 report.update_time += perfTimer.stop();
             }
 
@@ -355,6 +452,19 @@ namespace Opm {
         /// \param[in] timer                  simulation timer
         void afterStep(const SimulatorTimerInterface& timer OPM_UNUSED)
         {
+            if (param_.use_adaptive_implicit_) {
+                // remember how much the saturations changed during the time step. the
+                // adaptive implicit method keeps cells implicit if they were active
+                // during the previous time step.
+                const auto& solution = ebosSimulator_.model().solution(/*timeIdx=*/0);
+                const auto& oldSolution = ebosSimulator_.model().solution(/*timeIdx=*/1);
+                aim_last_step_saturation_change_.resize(solution.size());
+                for (unsigned cellIdx = 0; cellIdx < solution.size(); ++cellIdx) {
+                    aim_last_step_saturation_change_[cellIdx] =
+                        saturationChange_(solution[cellIdx], oldSolution[cellIdx]);
+                }
+            }
+
             ebosSimulator_.problem().endTimeStep();
         }
 
@@ -367,10 +477,36 @@ namespace Opm {
         {
             // -------- Mass balance equations --------
             ebosSimulator_.model().newtonMethod().setIterationIndex(iterationIdx);
+
+            const bool activeSet = activeSetRelinearizationEnabled_();
+            const bool partial = activeSet
+                && iterationIdx > 0
+                && active_set_stale_cache_
+                && active_set_linearizations_ < param_.max_active_set_linearizations_;
+            if (!partial && active_set_stale_cache_) {
+                // the intensive quantities of the cells which were skipped by the
+                // previous partial linearizations are outdated
+                ebosSimulator_.model().invalidateIntensiveQuantitiesCache(/*timeIdx=*/0);
+                active_set_stale_cache_ = false;
+            }
+
             ebosSimulator_.problem().beginIteration();
-            ebosSimulator_.model().linearizer().linearizeDomain();
+            if (partial) {
+                relinearizeActiveSet_();
+                ++active_set_linearizations_;
+            }
+            else {
+                ebosSimulator_.model().linearizer().linearizeDomain();
+                active_set_linearizations_ = 0;
+            }
             ebosSimulator_.problem().endIteration();
 
+            if (activeSet) {
+                // keep the residual before the well model applies its Schur complement
+                active_set_residual_ = ebosSimulator_.model().linearizer().residual();
+            }
+            last_linearization_partial_ = partial;
+
             return wellModel().lastReport();
         }
 
@@ -491,6 +627,12 @@ namespace Opm {
             auto& ebosNewtonMethod = ebosSimulator_.model().newtonMethod();
             SolutionVector& solution = ebosSimulator_.model().solution(/*timeIdx=*/0);
 
+            const bool activeSet = activeSetRelinearizationEnabled_();
+            SolutionVector oldSolution;
+            if (activeSet) {
+                oldSolution = solution;
+            }
+
             ebosNewtonMethod.update_(/*nextSolution=*/solution,
                                      /*curSolution=*/solution,
                                      /*update=*/dx,
@@ -498,8 +640,35 @@ namespace Opm {
                                                     // oil model do not care about the
                                                     // residual
 
-            // if the solution is updated, the intensive quantities need to be recalculated
-            ebosSimulator_.model().invalidateIntensiveQuantitiesCache(/*timeIdx=*/0);
+            // if the solution is updated, the intensive quantities need to be
+            // recalculated. for active set relinearization, this is only done for the
+            // cells which changed notably.
+            if (activeSet) {
+                markChangedCells_(oldSolution, solution);
+            }
+            else {
+                ebosSimulator_.model().invalidateIntensiveQuantitiesCache(/*timeIdx=*/0);
+            }
+        }
+
+        // The update which updateSolution() actually applied to the solution, i.e.,
+        // including the chopping. Newton updates are subtracted from the solution, so
+        // this is the old solution minus the current one. Cells which switched their
+        // primary variables keep the entries of dx, because the difference of their
+        // values is meaningless.
+        BVector appliedUpdate_(const SolutionVector& oldSolution, const BVector& dx) const
+        {
+            const SolutionVector& solution = ebosSimulator_.model().solution(/*timeIdx=*/0);
+            BVector applied(dx);
+            for (unsigned cellIdx = 0; cellIdx < solution.size(); ++cellIdx) {
+                if (solution[cellIdx].primaryVarsMeaning() != oldSolution[cellIdx].primaryVarsMeaning()) {
+                    continue;
+                }
+                for (int pvIdx = 0; pvIdx < numEq; ++pvIdx) {
+                    applied[cellIdx][pvIdx] = oldSolution[cellIdx][pvIdx] - solution[cellIdx][pvIdx];
+                }
+            }
+            return applied;
         }
 
         /// Return true if output to cout is wanted.
@@ -520,44 +689,42 @@ namespace Opm {
 
             if( comm.size() > 1 )
             {
-                // global reduction
-                std::vector< Scalar > sumBuffer;
-                std::vector< Scalar > maxBuffer;
+                // global reduction: the sums and the maxima are computed by a
+                // single collective operation
+                std::vector< Scalar > buffer;
                 const int numComp = B_avg.size();
-                sumBuffer.reserve( 2*numComp + 1 ); // +1 for pvSum
-                maxBuffer.reserve( numComp );
+                buffer.reserve( 3*numComp + 1 ); // +1 for pvSum
                 for( int compIdx = 0; compIdx < numComp; ++compIdx )
                 {
-                    sumBuffer.push_back( B_avg[ compIdx ] );
-                    sumBuffer.push_back( R_sum[ compIdx ] );
-                    maxBuffer.push_back( maxCoeff[ compIdx ] );
+                    buffer.push_back( B_avg[ compIdx ] );
+                    buffer.push_back( R_sum[ compIdx ] );
                 }
 
                 // Compute total pore volume
-                sumBuffer.push_back( pvSum );
+                buffer.push_back( pvSum );
+                const int numSum = buffer.size();
 
-                // compute global sum
-                comm.sum( sumBuffer.data(), sumBuffer.size() );
+                buffer.insert( buffer.end(), maxCoeff.begin(), maxCoeff.end() );
 
-                // compute global max
-                comm.max( maxBuffer.data(), maxBuffer.size() );
+                // compute global sum and max
+                allReduceSumMax( comm, buffer, numSum );
 
                 // restore values to local variables
                 for( int compIdx = 0, buffIdx = 0; compIdx < numComp; ++compIdx, ++buffIdx )
                 {
-                    B_avg[ compIdx ]    = sumBuffer[ buffIdx ];
+                    B_avg[ compIdx ]    = buffer[ buffIdx ];
                     ++buffIdx;
 
-                    R_sum[ compIdx ]       = sumBuffer[ buffIdx ];
+                    R_sum[ compIdx ]       = buffer[ buffIdx ];
                 }
 
                 for( int compIdx = 0; compIdx < numComp; ++compIdx )
                 {
-                    maxCoeff[ compIdx ] = maxBuffer[ compIdx ];
+                    maxCoeff[ compIdx ] = buffer[ numSum + compIdx ];
                 }
 
                 // restore global pore volume
-                pvSum = sumBuffer.back();
+                pvSum = buffer[ numSum - 1 ];
             }
 
             // return global pore volume
@@ -571,85 +738,703 @@ namespace Opm {
         {
             double pvSumLocal = 0.0;
             const auto& ebosModel = ebosSimulator_.model();
-            const auto& ebosProblem = ebosSimulator_.problem();
 
-            const auto& ebosResid = ebosSimulator_.model().linearizer().residual();
+            if (interior_cells_.empty()) {
+                collectInteriorCells_();
+            }
 
-            ElementContext elemCtx(ebosSimulator_);
-            const auto& gridView = ebosSimulator().gridView();
-            const auto& elemEndIt = gridView.template end</*codim=*/0, Dune::Interior_Partition>();
+            // The intensive quantities are normally still cached from the
+            // linearization. In that case the cells are distributed over the threads,
+            // each of which accumulates its own partial sums.
+            const bool allCached = std::all_of(interior_cells_.begin(), interior_cells_.end(),
+                                               [&ebosModel](const unsigned cell_idx)
+                                               {
+                                                   return ebosModel.cachedIntensiveQuantities(cell_idx, /*timeIdx=*/0) != nullptr;
+                                               });
+            if (allCached) {
+                const int numComp = B_avg.size();
+                const int numThreads = ThreadManager::maxThreads();
+                std::vector<double> threadPvSum(numThreads, 0.0);
+                std::vector<std::vector<Scalar>> threadR_sum(numThreads, std::vector<Scalar>(numComp, 0.0));
+                std::vector<std::vector<Scalar>> threadMaxCoeff(numThreads, std::vector<Scalar>(numComp, std::numeric_limits<Scalar>::lowest()));
+                std::vector<std::vector<Scalar>> threadB_avg(numThreads, std::vector<Scalar>(numComp, 0.0));
+
+                const int numCells = interior_cells_.size();
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif // HAVE_OPENMP
+                for (int i = 0; i < numCells; ++i) {
+                    const unsigned threadId = ThreadManager::threadId();
+                    const unsigned cell_idx = interior_cells_[i];
+                    const auto& intQuants = *ebosModel.cachedIntensiveQuantities(cell_idx, /*timeIdx=*/0);
+                    threadPvSum[threadId] += addCellConvergenceData_(cell_idx, intQuants,
+                                                                     threadR_sum[threadId],
+                                                                     threadMaxCoeff[threadId],
+                                                                     threadB_avg[threadId]);
+                }
 
-            for (auto elemIt = gridView.template begin</*codim=*/0, Dune::Interior_Partition>();
-                 elemIt != elemEndIt;
-                 ++elemIt)
+                // combine the partial results in a fixed order
+                for (int threadId = 0; threadId < numThreads; ++threadId) {
+                    pvSumLocal += threadPvSum[threadId];
+                    for (int compIdx = 0; compIdx < numComp; ++compIdx) {
+                        R_sum[compIdx] += threadR_sum[threadId][compIdx];
+                        maxCoeff[compIdx] = std::max(maxCoeff[compIdx], threadMaxCoeff[threadId][compIdx]);
+                        B_avg[compIdx] += threadB_avg[threadId][compIdx];
+                    }
+                }
+            }
+            else {
+                ElementContext elemCtx(ebosSimulator_);
+                const auto& gridView = ebosSimulator().gridView();
+                const auto& elemEndIt = gridView.template end</*codim=*/0, Dune::Interior_Partition>();
+
+                for (auto elemIt = gridView.template begin</*codim=*/0, Dune::Interior_Partition>();
+                     elemIt != elemEndIt;
+                     ++elemIt)
+                {
+                    const auto& elem = *elemIt;
+                    elemCtx.updatePrimaryStencil(elem);
+                    elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+                    const unsigned cell_idx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
+                    const auto& intQuants = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
+
+                    pvSumLocal += addCellConvergenceData_(cell_idx, intQuants, R_sum, maxCoeff, B_avg);
+                }
+            }
+
+            // compute local average in terms of global number of elements
+            const int bSize = B_avg.size();
+            for ( int i = 0; i<bSize; ++i )
             {
-                const auto& elem = *elemIt;
-                elemCtx.updatePrimaryStencil(elem);
-                elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-                const unsigned cell_idx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-                const auto& intQuants = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
-                const auto& fs = intQuants.fluidState();
+                B_avg[ i ] /= Scalar( global_nc_ );
+            }
 
-                const double pvValue = ebosProblem.referencePorosity(cell_idx, /*timeIdx=*/0) * ebosModel.dofTotalVolume( cell_idx );
-                pvSumLocal += pvValue;
+            return pvSumLocal;
+        }
 
-                for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx)
+        // Add the contribution of a single cell to the quantities needed for the
+        // convergence calculations and return the pore volume of the cell.
+        double addCellConvergenceData_(const unsigned cell_idx,
+                                       const IntensiveQuantities& intQuants,
+                                       std::vector<Scalar>& R_sum,
+                                       std::vector<Scalar>& maxCoeff,
+                                       std::vector<Scalar>& B_avg) const
+        {
+            const auto& ebosModel = ebosSimulator_.model();
+            const auto& ebosProblem = ebosSimulator_.problem();
+            const auto& ebosResid = ebosModel.linearizer().residual();
+            const auto& fs = intQuants.fluidState();
+
+            const double pvValue = ebosProblem.referencePorosity(cell_idx, /*timeIdx=*/0) * ebosModel.dofTotalVolume( cell_idx );
+
+            for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx)
+            {
+                if (!FluidSystem::phaseIsActive(phaseIdx)) {
+                    continue;
+                }
+
+                const unsigned compIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::solventComponentIndex(phaseIdx));
+
+                B_avg[ compIdx ] += 1.0 / fs.invB(phaseIdx).value();
+                const auto R2 = ebosResid[cell_idx][compIdx];
+
+                R_sum[ compIdx ] += R2;
+                maxCoeff[ compIdx ] = std::max( maxCoeff[ compIdx ], std::abs( R2 ) / pvValue );
+            }
+
+            if ( has_solvent_ ) {
+                B_avg[ contiSolventEqIdx ] += 1.0 / intQuants.solventInverseFormationVolumeFactor().value();
+                const auto R2 = ebosResid[cell_idx][contiSolventEqIdx];
+                R_sum[ contiSolventEqIdx ] += R2;
+                maxCoeff[ contiSolventEqIdx ] = std::max( maxCoeff[ contiSolventEqIdx ], std::abs( R2 ) / pvValue );
+            }
+            if (has_polymer_ ) {
+                B_avg[ contiPolymerEqIdx ] += 1.0 / fs.invB(FluidSystem::waterPhaseIdx).value();
+                const auto R2 = ebosResid[cell_idx][contiPolymerEqIdx];
+                R_sum[ contiPolymerEqIdx ] += R2;
+                maxCoeff[ contiPolymerEqIdx ] = std::max( maxCoeff[ contiPolymerEqIdx ], std::abs( R2 ) / pvValue );
+            }
+
+            if (has_polymermw_) {
+                assert(has_polymer_);
+
+                B_avg[contiPolymerMWEqIdx] += 1.0 / fs.invB(FluidSystem::waterPhaseIdx).value();
+                // the residual of the polymer molecular equation is scaled down by a 100, since molecular weight
+                // can be much bigger than 1, and this equation shares the same tolerance with other mass balance equations
+                // TODO: there should be a more general way to determine the scaling-down coefficient
+                const auto R2 = ebosResid[cell_idx][contiPolymerMWEqIdx] / 100.;
+                R_sum[contiPolymerMWEqIdx] += R2;
+                maxCoeff[contiPolymerMWEqIdx] = std::max( maxCoeff[contiPolymerMWEqIdx], std::abs( R2 ) / pvValue );
+            }
+
+            if (has_energy_ ) {
+                B_avg[ contiEnergyEqIdx ] += 1.0;
+                const auto R2 = ebosResid[cell_idx][contiEnergyEqIdx];
+                R_sum[ contiEnergyEqIdx ] += R2;
+                maxCoeff[ contiEnergyEqIdx ] = std::max( maxCoeff[ contiEnergyEqIdx ], std::abs( R2 ) / pvValue );
+            }
+
+            return pvValue;
+        }
+
+        // Reduce the linear system to the adaptive implicit formulation, see
+        // Opm::AdaptiveImplicitSystem. Returns false if all cells are treated fully
+        // implicitly. This only modifies the linear system: the original residual of the
+        // explicit cells is restored after the solve, so the convergence check and the
+        // Newton method still see the fully implicit residual.
+        bool prepareAdaptiveImplicitSystem_()
+        {
+            auto& jacobian = ebosSimulator_.model().linearizer().jacobian().istlMatrix();
+            auto& residual = ebosSimulator_.model().linearizer().residual();
+
+            if (!updateAdaptiveImplicitCells_(jacobian)) {
+                return false;
+            }
+
+            return aim_system_.reduce(jacobian, residual, aim_explicit_, Indices::pressureSwitchIdx);
+        }
+
+        // Determine the cells which are treated explicitly by the adaptive implicit
+        // method. Cells which are perforated by a well, which are adjacent to cells of
+        // other processes or which switched their primary variables stay implicit, as do
+        // the ones with a large throughput CFL number or saturation change.
+        bool updateAdaptiveImplicitCells_(const Mat& jacobian)
+        {
+            const unsigned numCells = jacobian.N();
+            if (interior_cells_.empty()) {
+                collectInteriorCells_();
+            }
+
+            // the per-cell buffers are reused by all Newton iterations
+            std::vector<bool>& isInterior = aim_interior_;
+            if (isInterior.size() != numCells) {
+                isInterior.assign(numCells, false);
+                for (const unsigned cellIdx : interior_cells_) {
+                    isInterior[cellIdx] = true;
+                }
+            }
+
+            std::vector<bool>& perforated = aim_perforated_;
+            perforated.assign(numCells, false);
+            wellModel().markPerforatedCells(perforated);
+
+            if (aim_last_step_saturation_change_.size() != numCells) {
+                aim_last_step_saturation_change_.assign(numCells, 0.0);
+            }
+
+            const auto& model = ebosSimulator_.model();
+            const auto& solution = model.solution(/*timeIdx=*/0);
+            const auto& oldSolution = model.solution(/*timeIdx=*/1);
+            const double maxSaturationChange = param_.adaptive_implicit_max_saturation_change_;
+
+            aim_explicit_.assign(numCells, false);
+            bool anyExplicit = false;
+            for (auto row = jacobian.begin(); row != jacobian.end(); ++row) {
+                const unsigned cellIdx = row.index();
+                if (!isInterior[cellIdx] || perforated[cellIdx]) {
+                    continue;
+                }
+
+                bool isExplicit =
+                    solution[cellIdx].primaryVarsMeaning() == oldSolution[cellIdx].primaryVarsMeaning()
+                    && saturationChange_(solution[cellIdx], oldSolution[cellIdx]) <= maxSaturationChange
+                    && aim_last_step_saturation_change_[cellIdx] <= maxSaturationChange;
+                for (auto col = row->begin(); isExplicit && col != row->end(); ++col) {
+                    isExplicit = isInterior[col.index()];
+                }
+
+                aim_explicit_[cellIdx] = isExplicit;
+                anyExplicit = anyExplicit || isExplicit;
+            }
+
+            if (!anyExplicit) {
+                return false;
+            }
+
+            // compute the throughput of the candidates, i.e., the volumetric rate of the
+            // fluids which leave them. the remaining cells and faces are not of interest.
+            const auto& problem = ebosSimulator_.problem();
+            const auto& transmissibilities = problem.eclTransmissibilities();
+            const Scalar gravity = problem.gravity()[Grid::dimensionworld - 1];
+            std::vector<Scalar>& throughput = aim_throughput_;
+            throughput.assign(numCells, 0.0);
+            for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+                for (unsigned faceIdx = transmissibilities.faceBegin(cellIdx);
+                     faceIdx < transmissibilities.faceEnd(cellIdx);
+                     ++faceIdx)
                 {
-                    if (!FluidSystem::phaseIsActive(phaseIdx)) {
+                    const unsigned neighborIdx = transmissibilities.faceNeighbor(faceIdx);
+                    if (!aim_explicit_[cellIdx] && !aim_explicit_[neighborIdx]) {
                         continue;
                     }
 
-                    const unsigned compIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::solventComponentIndex(phaseIdx));
+                    const auto* intQuantsIn = model.cachedIntensiveQuantities(cellIdx, /*timeIdx=*/0);
+                    const auto* intQuantsEx = model.cachedIntensiveQuantities(neighborIdx, /*timeIdx=*/0);
+                    if (!intQuantsIn || !intQuantsEx) {
+                        // the intensive quantities are not available, so we do not know
+                        // where the fronts are
+                        return false;
+                    }
 
-                    B_avg[ compIdx ] += 1.0 / fs.invB(phaseIdx).value();
-                    const auto R2 = ebosResid[cell_idx][compIdx];
+                    const Scalar trans = transmissibilities.faceTransmissibility(faceIdx);
+                    const Scalar distZ = problem.dofCenterDepth(cellIdx) - problem.dofCenterDepth(neighborIdx);
+                    const auto& fsIn = intQuantsIn->fluidState();
+                    const auto& fsEx = intQuantsEx->fluidState();
+                    for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
+                        if (!FluidSystem::phaseIsActive(phaseIdx)) {
+                            continue;
+                        }
 
-                    R_sum[ compIdx ] += R2;
-                    maxCoeff[ compIdx ] = std::max( maxCoeff[ compIdx ], std::abs( R2 ) / pvValue );
+                        // same convention as in the flux module: a positive value means
+                        // that the fluid flows from the neighbor to the cell
+                        const Scalar rhoAvg = (fsIn.density(phaseIdx).value() + fsEx.density(phaseIdx).value())/2;
+                        const Scalar potentialDifference =
+                            fsEx.pressure(phaseIdx).value() + rhoAvg*distZ*gravity
+                            - fsIn.pressure(phaseIdx).value();
+                        if (potentialDifference > 0.0) {
+                            throughput[neighborIdx] += trans*intQuantsEx->mobility(phaseIdx).value()*potentialDifference;
+                        }
+                        else {
+                            throughput[cellIdx] -= trans*intQuantsIn->mobility(phaseIdx).value()*potentialDifference;
+                        }
+                    }
                 }
+            }
 
-                if ( has_solvent_ ) {
-                    B_avg[ contiSolventEqIdx ] += 1.0 / intQuants.solventInverseFormationVolumeFactor().value();
-                    const auto R2 = ebosResid[cell_idx][contiSolventEqIdx];
-                    R_sum[ contiSolventEqIdx ] += R2;
-                    maxCoeff[ contiSolventEqIdx ] = std::max( maxCoeff[ contiSolventEqIdx ], std::abs( R2 ) / pvValue );
+            const double dt = ebosSimulator_.timeStepSize();
+            anyExplicit = false;
+            for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+                if (!aim_explicit_[cellIdx]) {
+                    continue;
                 }
-                if (has_polymer_ ) {
-                    B_avg[ contiPolymerEqIdx ] += 1.0 / fs.invB(FluidSystem::waterPhaseIdx).value();
-                    const auto R2 = ebosResid[cell_idx][contiPolymerEqIdx];
-                    R_sum[ contiPolymerEqIdx ] += R2;
-                    maxCoeff[ contiPolymerEqIdx ] = std::max( maxCoeff[ contiPolymerEqIdx ], std::abs( R2 ) / pvValue );
+
+                const auto* intQuants = model.cachedIntensiveQuantities(cellIdx, /*timeIdx=*/0);
+                if (!intQuants) {
+                    aim_explicit_[cellIdx] = false;
+                    continue;
                 }
 
-                if (has_polymermw_) {
-                    assert(has_polymer_);
+                const double poreVolume = intQuants->porosity().value()*model.dofTotalVolume(cellIdx);
+                aim_explicit_[cellIdx] =
+                    poreVolume > 0.0 && dt*throughput[cellIdx] <= param_.adaptive_implicit_max_cfl_*poreVolume;
+                anyExplicit = anyExplicit || aim_explicit_[cellIdx];
+            }
+
+            return anyExplicit;
+        }
+
+        // Recover the update of the saturations and compositions of the cells which were
+        // treated explicitly from the solution of the reduced linear system.
+        void recoverAdaptiveImplicitUpdate_(BVector& x)
+        {
+            aim_system_.recover(x);
+            restoreAdaptiveImplicitResidual_();
+        }
+
+        // Undo the scaling of the residual of the explicit cells by
+        // prepareAdaptiveImplicitSystem_().
+        void restoreAdaptiveImplicitResidual_()
+        {
+            aim_system_.restoreRhs(ebosSimulator_.model().linearizer().residual());
+        }
 
-                    B_avg[contiPolymerMWEqIdx] += 1.0 / fs.invB(FluidSystem::waterPhaseIdx).value();
-                    // the residual of the polymer molecular equation is scaled down by a 100, since molecular weight
-                    // can be much bigger than 1, and this equation shares the same tolerance with other mass balance equations
-                    // TODO: there should be a more general way to determine the scaling-down coefficient
-                    const auto R2 = ebosResid[cell_idx][contiPolymerMWEqIdx] / 100.;
-                    R_sum[contiPolymerMWEqIdx] += R2;
-                    maxCoeff[contiPolymerMWEqIdx] = std::max( maxCoeff[contiPolymerMWEqIdx], std::abs( R2 ) / pvValue );
+        // the largest change of a saturation between two sets of primary variables
+        static Scalar saturationChange_(const PrimaryVariables& priVarsNew,
+                                        const PrimaryVariables& priVarsOld)
+        {
+            Scalar change = 0.0;
+            if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+                change = std::abs(priVarsNew[Indices::waterSaturationIdx] - priVarsOld[Indices::waterSaturationIdx]);
+            }
+
+            if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)
+                && priVarsNew.primaryVarsMeaning() == PrimaryVariables::Sw_po_Sg
+                && priVarsOld.primaryVarsMeaning() == PrimaryVariables::Sw_po_Sg)
+            {
+                change = std::max(change, std::abs(priVarsNew[Indices::compositionSwitchIdx]
+                                                   - priVarsOld[Indices::compositionSwitchIdx]));
+            }
+
+            return change;
+        }
+
+        // Do a few Newton iterations which only update the cells that violate the CNV
+        // criterion plus some layers of their neighbors. The remaining cells act as
+        // fixed boundary values. The linearization is updated after each of them, so the
+        // global update which follows is based on the current solution. 'converged' is
+        // set to true if the local updates removed all violations of the CNV criterion.
+        //
+        // The local updates are not part of the history of the Anderson acceleration and
+        // of the line search, so both are restarted if any local update was applied. If
+        // the local updates did not converge, the residual norms of the previous
+        // iterations do not describe the current solution anymore, so the history used
+        // for the oscillation detection is restarted as well.
+        SimulatorReport solveLocalDomains_(const SimulatorTimerInterface& timer,
+                                           const int iteration,
+                                           bool& converged)
+        {
+            SimulatorReport report;
+            std::vector<unsigned> domainCells;
+            converged = false;
+            int numLocalUpdates = 0;
+            for (int localIter = 0; ; ++localIter) {
+                if (!selectLocalDomainCells_(timer.currentStepLength(), domainCells)) {
+                    converged = numLocalUpdates > 0 && domainCells.empty();
+                    break;
+                }
+                if (localIter == param_.max_local_newton_iterations_) {
+                    break;
                 }
 
-                if (has_energy_ ) {
-                    B_avg[ contiEnergyEqIdx ] += 1.0;
-                    const auto R2 = ebosResid[cell_idx][contiEnergyEqIdx];
-                    R_sum[ contiEnergyEqIdx ] += R2;
-                    maxCoeff[ contiEnergyEqIdx ] = std::max( maxCoeff[ contiEnergyEqIdx ], std::abs( R2 ) / pvValue );
+                Dune::Timer perfTimer;
+                perfTimer.start();
+                BVector x(UgGridHelpers::numCells(grid_));
+                int linearIterations = 0;
+                const bool solved = solveLocalDomain_(domainCells, x, linearIterations);
+                report.linear_solve_time += perfTimer.stop();
+                report.total_linear_iterations += linearIterations;
+                if (!solved) {
+                    break;
                 }
 
+                updateSolution(x);
+                ++numLocalUpdates;
+
+                perfTimer.reset();
+                perfTimer.start();
+                report += assembleReservoir(timer, iteration);
+                report.total_linearizations += 1;
+                report.assemble_time += perfTimer.stop();
             }
 
-            // compute local average in terms of global number of elements
-            const int bSize = B_avg.size();
-            for ( int i = 0; i<bSize; ++i )
+            if (numLocalUpdates > 0) {
+                anderson_dx_.clear();
+                anderson_applied_.clear();
+                line_search_possible_ = false;
+                if (!converged) {
+                    residual_norms_history_.clear();
+                }
+            }
+
+            return report;
+        }
+
+        // Select the cells of the local subdomains, i.e., the cells which violate the
+        // CNV criterion and the given number of layers of their neighbors. Cells which
+        // are perforated by wells are kept fixed. Returns false if no cell violates the
+        // criterion or if so many of them do that a global update is preferable.
+        bool selectLocalDomainCells_(const double dt, std::vector<unsigned>& domainCells) const
+        {
+            const auto& ebosModel = ebosSimulator_.model();
+            const auto& ebosProblem = ebosSimulator_.problem();
+            const auto& ebosResid = ebosModel.linearizer().residual();
+            const auto& jacobian = ebosModel.linearizer().jacobian().istlMatrix();
+            const unsigned numCells = jacobian.N();
+
+            std::vector<bool> perforated(numCells, false);
+            wellModel().markPerforatedCells(perforated);
+
+            std::vector<bool> inDomain(numCells, false);
+            domainCells.clear();
+            for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+                if (perforated[cellIdx]) {
+                    continue;
+                }
+
+                const double pvValue = ebosProblem.referencePorosity(cellIdx, /*timeIdx=*/0) * ebosModel.dofTotalVolume(cellIdx);
+                for (int eqIdx = 0; eqIdx < numEq; ++eqIdx) {
+                    if (B_avg_[eqIdx]*dt*std::abs(ebosResid[cellIdx][eqIdx]) > param_.tolerance_cnv_*pvValue) {
+                        inDomain[cellIdx] = true;
+                        domainCells.push_back(cellIdx);
+                        break;
+                    }
+                }
+            }
+
+            if (domainCells.empty() || domainCells.size() > param_.local_newton_max_cell_fraction_*numCells) {
+                return false;
+            }
+
+            // add the layers of neighbors
+            std::size_t layerBegin = 0;
+            for (int layerIdx = 0; layerIdx < param_.local_newton_overlap_; ++layerIdx) {
+                const std::size_t layerEnd = domainCells.size();
+                for (std::size_t i = layerBegin; i < layerEnd; ++i) {
+                    const auto& row = jacobian[domainCells[i]];
+                    for (auto col = row.begin(); col != row.end(); ++col) {
+                        if (!inDomain[col.index()] && !perforated[col.index()]) {
+                            inDomain[col.index()] = true;
+                            domainCells.push_back(col.index());
+                        }
+                    }
+                }
+                layerBegin = layerEnd;
+            }
+
+            std::sort(domainCells.begin(), domainCells.end());
+            return true;
+        }
+
+        // Solve the linear system restricted to the given cells, i.e., for a zero update
+        // in all other cells. Returns false if the linear solver did not converge.
+        bool solveLocalDomain_(const std::vector<unsigned>& domainCells,
+                               BVector& x,
+                               int& linearIterations) const
+        {
+            const auto& jacobian = ebosSimulator_.model().linearizer().jacobian().istlMatrix();
+            const auto& residual = ebosSimulator_.model().linearizer().residual();
+
+            std::vector<int> localIdx(jacobian.N(), -1);
+            for (std::size_t i = 0; i < domainCells.size(); ++i) {
+                localIdx[domainCells[i]] = i;
+            }
+
+            std::size_t numNonZeros = 0;
+            for (const unsigned cellIdx : domainCells) {
+                const auto& row = jacobian[cellIdx];
+                for (auto col = row.begin(); col != row.end(); ++col) {
+                    numNonZeros += localIdx[col.index()] >= 0;
+                }
+            }
+
+            const std::size_t numLocalCells = domainCells.size();
+            Mat localMatrix(numLocalCells, numLocalCells, numNonZeros, Mat::row_wise);
+            for (auto row = localMatrix.createbegin(); row != localMatrix.createend(); ++row) {
+                const auto& globalRow = jacobian[domainCells[row.index()]];
+                for (auto col = globalRow.begin(); col != globalRow.end(); ++col) {
+                    if (localIdx[col.index()] >= 0) {
+                        row.insert(localIdx[col.index()]);
+                    }
+                }
+            }
+
+            BVector localResidual(numLocalCells);
+            for (std::size_t i = 0; i < numLocalCells; ++i) {
+                const auto& globalRow = jacobian[domainCells[i]];
+                for (auto col = globalRow.begin(); col != globalRow.end(); ++col) {
+                    if (localIdx[col.index()] >= 0) {
+                        localMatrix[i][localIdx[col.index()]] = *col;
+                    }
+                }
+                localResidual[i] = residual[domainCells[i]];
+            }
+
+            // the subdomains are small compared to the reservoir, so a simple
+            // preconditioner is sufficient.
+            Dune::MatrixAdapter<Mat, BVector, BVector> localOperator(localMatrix);
+            Dune::SeqILU0<Mat, BVector, BVector> preconditioner(localMatrix, 1.0);
+            Dune::BiCGSTABSolver<BVector> solver(localOperator, preconditioner,
+                                                 param_.local_newton_linear_tolerance_,
+                                                 param_.local_newton_max_linear_iterations_,
+                                                 /*verbose=*/0);
+
+            BVector localX(numLocalCells);
+            localX = 0.0;
+            Dune::InverseOperatorResult result;
+            solver.apply(localX, localResidual, result);
+            linearIterations = result.iterations;
+            if (!result.converged) {
+                return false;
+            }
+
+            x = 0.0;
+            for (std::size_t i = 0; i < numLocalCells; ++i) {
+                x[domainCells[i]] = localX[i];
+            }
+
+            return true;
+        }
+
+        // Halve the last update of the reservoir as long as the sum of the CNV residual
+        // norms is larger than before it. The residual norms and the convergence
+        // report are the ones of the current linearization. The well state keeps the
+        // full update because the well solution cannot be recovered for a scaled update
+        // once the well equations have been reassembled.
+        SimulatorReport lineSearch_(const SimulatorTimerInterface& timer,
+                                    const int iteration,
+                                    std::vector<double>& residual_norms,
+                                    ConvergenceReport& convrep)
+        {
+            SimulatorReport report;
+            line_search_possible_ = false;
+            if (residual_norms_history_.empty()) {
+                return report;
+            }
+
+            const auto norm = [](const std::vector<double>& norms)
             {
-                B_avg[ i ] /= Scalar( global_nc_ );
+                return std::accumulate(norms.begin(), norms.end(), 0.0);
+            };
+            const double previousNorm = norm(residual_norms_history_.back());
+            double lambda = 1.0;
+            for (int lsIter = 0; lsIter < param_.max_line_search_iterations_; ++lsIter) {
+                // also backtrack if the residual is not a number
+                if (norm(residual_norms) <= previousNorm) {
+                    break;
+                }
+
+                lambda *= 0.5;
+                ebosSimulator_.model().solution(/*timeIdx=*/0) = line_search_solution_;
+                ebosSimulator_.model().invalidateIntensiveQuantitiesCache(/*timeIdx=*/0);
+                // the previous linearization does not correspond to the restored
+                // solution, so it cannot be partially reused
+                active_set_linearizations_ = param_.max_active_set_linearizations_;
+
+                BVector dx(line_search_dx_);
+                dx *= lambda;
+                updateSolution(dx);
+
+                report += assembleReservoir(timer, iteration);
+                report.total_linearizations += 1;
+                residual_norms.clear();
+                convrep = getConvergence(timer, iteration, residual_norms);
             }
 
-            return pvSumLocal;
+            if (lambda < 1.0) {
+                if (!anderson_applied_.empty()) {
+                    BVector dx(line_search_dx_);
+                    dx *= lambda;
+                    anderson_applied_.back() = appliedUpdate_(line_search_solution_, dx);
+                }
+                if (terminalOutputEnabled()) {
+                    OpmLog::debug("    Line search: last update scaled by " + std::to_string(lambda));
+                }
+            }
+
+            return report;
+        }
+
+        // The partial linearization reuses the Jacobian of the previous linearization,
+        // so it cannot be combined with the features which modify it in place.
+        bool activeSetRelinearizationEnabled_() const
+        {
+            return param_.use_active_set_relinearization_
+                && !param_.use_adaptive_implicit_
+                && !param_.matrix_add_well_contributions_
+                && !isParallel();
+        }
+
+        // Mark the cells whose primary variables changed by more than the tolerance
+        // relative to their magnitude (or absolutely for values below one) or which
+        // switched the meaning of their primary variables. Cells perforated by wells
+        // are always marked because the well rates are reassembled in each iteration.
+        // Only the cached intensive quantities of the marked cells are invalidated.
+        void markChangedCells_(const SolutionVector& oldSolution, const SolutionVector& solution)
+        {
+            auto& ebosModel = ebosSimulator_.model();
+            const unsigned numCells = solution.size();
+            const Scalar tolerance = param_.active_set_relinearization_tolerance_;
+
+            active_set_changed_.assign(numCells, false);
+            wellModel().markPerforatedCells(active_set_changed_);
+            for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+                const auto& oldPriVars = oldSolution[cellIdx];
+                const auto& priVars = solution[cellIdx];
+                bool changed = active_set_changed_[cellIdx]
+                    || oldPriVars.primaryVarsMeaning() != priVars.primaryVarsMeaning();
+                for (int pvIdx = 0; pvIdx < numEq && !changed; ++pvIdx) {
+                    const Scalar scale = std::max(std::abs(oldPriVars[pvIdx]), Scalar(1.0));
+                    changed = std::abs(priVars[pvIdx] - oldPriVars[pvIdx]) > tolerance*scale;
+                }
+
+                if (changed) {
+                    active_set_changed_[cellIdx] = true;
+                    ebosModel.setIntensiveQuantitiesCacheEntryValidity(cellIdx, /*timeIdx=*/0, false);
+                }
+            }
+
+            active_set_stale_cache_ = true;
+        }
+
+        // Relinearize the elements for which any cell of their stencil changed during
+        // the last update. The local linearization of an element determines the
+        // residual of its cell and the column of its primary variables in the
+        // Jacobian, so the remaining entries of the previous linearization stay valid.
+        void relinearizeActiveSet_()
+        {
+            auto& ebosModel = ebosSimulator_.model();
+            auto& jacobian = ebosModel.linearizer().jacobian().istlMatrix();
+            auto& residual = ebosModel.linearizer().residual();
+            const auto& elemMapper = ebosModel.elementMapper();
+            const unsigned numCells = jacobian.N();
+
+            // the sparsity pattern is symmetric, i.e., the row of a changed cell
+            // contains all elements whose stencil includes it
+            std::vector<bool> relinearize(active_set_changed_);
+            for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+                if (!active_set_changed_[cellIdx]) {
+                    continue;
+                }
+
+                const auto& row = jacobian[cellIdx];
+                for (auto col = row.begin(); col != row.end(); ++col) {
+                    relinearize[col.index()] = true;
+                }
+            }
+
+            // the well model and the linear solver may have modified the residual of
+            // the linearizer since it was assembled
+            residual = active_set_residual_;
+
+            bool succeeded = true;
+            Ewoms::ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(ebosSimulator_.gridView());
+#if HAVE_OPENMP
+#pragma omp parallel
+#endif // HAVE_OPENMP
+            {
+                const unsigned threadId = ThreadManager::threadId();
+                auto& localLinearizer = ebosModel.localLinearizer(threadId);
+                ElementContext elemCtx(ebosSimulator_);
+                auto elemIt = threadedElemIt.beginParallel();
+                for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
+                    const auto& elem = *elemIt;
+                    if (!relinearize[elemMapper.index(elem)]) {
+                        continue;
+                    }
+
+                    try {
+                        localLinearizer.linearize(elemCtx, elem);
+                    }
+                    catch (const std::exception&) {
+#if HAVE_OPENMP
+#pragma omp critical
+#endif // HAVE_OPENMP
+                        succeeded = false;
+                        continue;
+                    }
+
+                    for (unsigned primaryDofIdx = 0; primaryDofIdx < elemCtx.numPrimaryDof(/*timeIdx=*/0); ++primaryDofIdx) {
+                        const unsigned globI = elemCtx.globalSpaceIndex(primaryDofIdx, /*timeIdx=*/0);
+                        residual[globI] = localLinearizer.residual(primaryDofIdx);
+                        for (unsigned dofIdx = 0; dofIdx < elemCtx.numDof(/*timeIdx=*/0); ++dofIdx) {
+                            const unsigned globJ = elemCtx.globalSpaceIndex(dofIdx, /*timeIdx=*/0);
+                            auto& block = jacobian[globJ][globI];
+                            block = 0.0;
+                            block += localLinearizer.jacobian(dofIdx, primaryDofIdx);
+                        }
+                    }
+                }
+            }
+
+            if (!succeeded) {
+                OPM_THROW(Opm::NumericalIssue, "Relinearization of the active cells failed");
+            }
+        }
+
+        // Collect the indices of the interior cells of this process.
+        void collectInteriorCells_()
+        {
+            interior_cells_.clear();
+            ElementContext elemCtx(ebosSimulator_);
+            const auto& gridView = ebosSimulator().gridView();
+            const auto& elemEndIt = gridView.template end</*codim=*/0, Dune::Interior_Partition>();
+            for (auto elemIt = gridView.template begin</*codim=*/0, Dune::Interior_Partition>();
+                 elemIt != elemEndIt;
+                 ++elemIt)
+            {
+                elemCtx.updatePrimaryStencil(*elemIt);
+                interior_cells_.push_back(elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0));
+            }
         }
 
         ConvergenceReport getReservoirConvergence(const double dt,
@@ -787,6 +1572,7 @@ namespace Opm {
             std::vector<Scalar> B_avg(numEq, 0.0);
             auto report = getReservoirConvergence(timer.currentStepLength(), iteration, B_avg, residual_norms);
             report += wellModel().getWellConvergence(B_avg);
+            B_avg_ = B_avg;
 
             return report;
         }
@@ -838,6 +1624,19 @@ namespace Opm {
             return convergence_reports_;
         }
 
+        /// Return the CNV residual norms of the components for each nonlinear
+        /// iteration of the current time step.
+        const std::vector<std::vector<double>>& residualNormsHistory() const
+        {
+            return residual_norms_history_;
+        }
+
+        /// Return the parameters of the model.
+        const ModelParameters& param() const
+        {
+            return param_;
+        }
+
     protected:
         const ISTLSolverType& istlSolver() const
         {
@@ -868,11 +1667,54 @@ namespace Opm {
         bool terminal_output_;
         /// \brief The number of cells of the global grid.
         long int global_nc_;
+        /// \brief The indices of the interior cells of this process.
+        std::vector<unsigned> interior_cells_;
+        /// \brief The average formation volume factors of the last convergence check.
+        std::vector<Scalar> B_avg_;
+
+        /// \brief Adaptive implicit method: whether a cell is treated explicitly.
+        std::vector<bool> aim_explicit_;
+        /// \brief Adaptive implicit method: the saturation change of each cell during
+        ///        the previous time step.
+        std::vector<Scalar> aim_last_step_saturation_change_;
+        /// \brief Adaptive implicit method: the reduction of the linear system.
+        AdaptiveImplicitSystem<Mat, BVector> aim_system_;
+        /// \brief Adaptive implicit method: buffers for selecting the explicit cells.
+        std::vector<bool> aim_interior_;
+        std::vector<bool> aim_perforated_;
+        std::vector<Scalar> aim_throughput_;
 
         std::vector<std::vector<double>> residual_norms_history_;
         double current_relaxation_;
         BVector dx_old_;
 
+        /// \brief Active set relinearization: the cells which changed notably during
+        ///        the last update.
+        std::vector<bool> active_set_changed_;
+        /// \brief Active set relinearization: the residual of the last linearization.
+        BVector active_set_residual_;
+        /// \brief Active set relinearization: the number of consecutive partial
+        ///        linearizations.
+        int active_set_linearizations_;
+        /// \brief Active set relinearization: whether some cached intensive quantities
+        ///        do not correspond to the current solution.
+        bool active_set_stale_cache_;
+        /// \brief Whether the last linearization skipped some cells.
+        bool last_linearization_partial_;
+
+        /// \brief Anderson acceleration: the Newton updates and the applied updates
+        ///        of the previous iterations of the time step.
+        std::vector<BVector> anderson_dx_;
+        std::vector<BVector> anderson_applied_;
+
+        /// \brief Line search: the solution before the last update and the update. The
+        ///        solution is also used to determine the applied update for the
+        ///        Anderson acceleration.
+        SolutionVector line_search_solution_;
+        BVector line_search_dx_;
+        /// \brief Whether the last update can be scaled back by the line search.
+        bool line_search_possible_;
+
         std::vector<StepReport> convergence_reports_;
     public:
         /// return the StandardWells object
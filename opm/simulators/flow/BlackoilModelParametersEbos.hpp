@@ -48,6 +48,22 @@ NEW_PROP_TAG(SolveWelleqInitially);
 NEW_PROP_TAG(UpdateEquationsScaling);
 NEW_PROP_TAG(UseUpdateStabilization);
 NEW_PROP_TAG(MatrixAddWellContributions);
+NEW_PROP_TAG(UseAdaptiveImplicit);
+NEW_PROP_TAG(AdaptiveImplicitMaxCfl);
+NEW_PROP_TAG(AdaptiveImplicitMaxSaturationChange);
+NEW_PROP_TAG(UseLocalNewton);
+NEW_PROP_TAG(MaxLocalNewtonIterations);
+NEW_PROP_TAG(LocalNewtonMaxCellFraction);
+NEW_PROP_TAG(LocalNewtonOverlap);
+NEW_PROP_TAG(LocalNewtonLinearTolerance);
+NEW_PROP_TAG(LocalNewtonMaxLinearIterations);
+NEW_PROP_TAG(UseActiveSetRelinearization);
+NEW_PROP_TAG(ActiveSetRelinearizationTolerance);
+NEW_PROP_TAG(MaxActiveSetLinearizations);
+NEW_PROP_TAG(UseAndersonAcceleration);
+NEW_PROP_TAG(AndersonAccelerationDepth);
+NEW_PROP_TAG(UseLineSearch);
+NEW_PROP_TAG(MaxLineSearchIterations);
 
 // parameters for multisegment wells
 NEW_PROP_TAG(TolerancePressureMsWells);
@@ -71,6 +87,22 @@ SET_BOOL_PROP(FlowModelParameters, SolveWelleqInitially, true);
 SET_BOOL_PROP(FlowModelParameters, UpdateEquationsScaling, false);
 SET_BOOL_PROP(FlowModelParameters, UseUpdateStabilization, true);
 SET_BOOL_PROP(FlowModelParameters, MatrixAddWellContributions, false);
+SET_BOOL_PROP(FlowModelParameters, UseAdaptiveImplicit, false);
+SET_SCALAR_PROP(FlowModelParameters, AdaptiveImplicitMaxCfl, 0.5);
+SET_SCALAR_PROP(FlowModelParameters, AdaptiveImplicitMaxSaturationChange, 0.02);
+SET_BOOL_PROP(FlowModelParameters, UseLocalNewton, false);
+SET_INT_PROP(FlowModelParameters, MaxLocalNewtonIterations, 3);
+SET_SCALAR_PROP(FlowModelParameters, LocalNewtonMaxCellFraction, 0.2);
+SET_INT_PROP(FlowModelParameters, LocalNewtonOverlap, 2);
+SET_SCALAR_PROP(FlowModelParameters, LocalNewtonLinearTolerance, 1e-3);
+SET_INT_PROP(FlowModelParameters, LocalNewtonMaxLinearIterations, 200);
+SET_BOOL_PROP(FlowModelParameters, UseActiveSetRelinearization, false);
+SET_SCALAR_PROP(FlowModelParameters, ActiveSetRelinearizationTolerance, 1e-4);
+SET_INT_PROP(FlowModelParameters, MaxActiveSetLinearizations, 3);
+SET_BOOL_PROP(FlowModelParameters, UseAndersonAcceleration, false);
+SET_INT_PROP(FlowModelParameters, AndersonAccelerationDepth, 3);
+SET_BOOL_PROP(FlowModelParameters, UseLineSearch, false);
+SET_INT_PROP(FlowModelParameters, MaxLineSearchIterations, 3);
 SET_SCALAR_PROP(FlowModelParameters, TolerancePressureMsWells, 0.01 *1e5);
 SET_SCALAR_PROP(FlowModelParameters, MaxPressureChangeMsWells, 1e6);
 SET_BOOL_PROP(FlowModelParameters, UseInnerIterationsMsWells, true);
@@ -153,6 +185,60 @@ namespace Opm
         // Whether to add influences of wells between cells to the matrix and preconditioner matrix
         bool matrix_add_well_contributions_;
 
+        /// Whether to treat quiescent cells implicit in pressure and explicit in the
+        /// remaining primary variables when solving for the Newton update
+        bool use_adaptive_implicit_;
+
+        /// Maximum throughput CFL number of a cell which is treated explicitly
+        double adaptive_implicit_max_cfl_;
+
+        /// Maximum saturation change of a cell which is treated explicitly
+        double adaptive_implicit_max_saturation_change_;
+
+        /// Whether to solve for the cells which violate the CNV criterion with fixed
+        /// boundary values before each global Newton update
+        bool use_local_newton_;
+
+        /// Maximum number of local iterations before each global Newton update
+        int max_local_newton_iterations_;
+
+        /// Maximum fraction of cells violating the CNV criterion for which the local
+        /// iterations are done
+        double local_newton_max_cell_fraction_;
+
+        /// Number of layers of cells added around the cells violating the CNV criterion
+        int local_newton_overlap_;
+
+        /// Relative reduction of the residual required from the linear solver of the
+        /// local iterations
+        double local_newton_linear_tolerance_;
+
+        /// Maximum number of linear iterations for each local iteration
+        int local_newton_max_linear_iterations_;
+
+        /// Whether to relinearize only the cells whose primary variables changed
+        /// significantly during the last Newton update and their neighbors
+        bool use_active_set_relinearization_;
+
+        /// Relative change of a primary variable above which a cell is relinearized
+        double active_set_relinearization_tolerance_;
+
+        /// Maximum number of consecutive partial linearizations before the whole
+        /// reservoir is relinearized
+        int max_active_set_linearizations_;
+
+        /// Whether to apply Anderson acceleration to the Newton updates
+        bool use_anderson_acceleration_;
+
+        /// Number of previous Newton iterations used by Anderson acceleration
+        int anderson_acceleration_depth_;
+
+        /// Whether to halve the last update if the residual increased
+        bool use_line_search_;
+
+        /// Maximum number of times the last update is halved
+        int max_line_search_iterations_;
+
         /// Construct from user parameters or defaults.
         BlackoilModelParametersEbos()
         {
@@ -176,6 +262,22 @@ namespace Opm
             update_equations_scaling_ = EWOMS_GET_PARAM(TypeTag, bool, UpdateEquationsScaling);
             use_update_stabilization_ = EWOMS_GET_PARAM(TypeTag, bool, UseUpdateStabilization);
             matrix_add_well_contributions_ = EWOMS_GET_PARAM(TypeTag, bool, MatrixAddWellContributions);
+            use_adaptive_implicit_ = EWOMS_GET_PARAM(TypeTag, bool, UseAdaptiveImplicit);
+            adaptive_implicit_max_cfl_ = EWOMS_GET_PARAM(TypeTag, Scalar, AdaptiveImplicitMaxCfl);
+            adaptive_implicit_max_saturation_change_ = EWOMS_GET_PARAM(TypeTag, Scalar, AdaptiveImplicitMaxSaturationChange);
+            use_local_newton_ = EWOMS_GET_PARAM(TypeTag, bool, UseLocalNewton);
+            max_local_newton_iterations_ = EWOMS_GET_PARAM(TypeTag, int, MaxLocalNewtonIterations);
+            local_newton_max_cell_fraction_ = EWOMS_GET_PARAM(TypeTag, Scalar, LocalNewtonMaxCellFraction);
+            local_newton_overlap_ = EWOMS_GET_PARAM(TypeTag, int, LocalNewtonOverlap);
+            local_newton_linear_tolerance_ = EWOMS_GET_PARAM(TypeTag, Scalar, LocalNewtonLinearTolerance);
+            local_newton_max_linear_iterations_ = EWOMS_GET_PARAM(TypeTag, int, LocalNewtonMaxLinearIterations);
+            use_active_set_relinearization_ = EWOMS_GET_PARAM(TypeTag, bool, UseActiveSetRelinearization);
+            active_set_relinearization_tolerance_ = EWOMS_GET_PARAM(TypeTag, Scalar, ActiveSetRelinearizationTolerance);
+            max_active_set_linearizations_ = EWOMS_GET_PARAM(TypeTag, int, MaxActiveSetLinearizations);
+            use_anderson_acceleration_ = EWOMS_GET_PARAM(TypeTag, bool, UseAndersonAcceleration);
+            anderson_acceleration_depth_ = EWOMS_GET_PARAM(TypeTag, int, AndersonAccelerationDepth);
+            use_line_search_ = EWOMS_GET_PARAM(TypeTag, bool, UseLineSearch);
+            max_line_search_iterations_ = EWOMS_GET_PARAM(TypeTag, int, MaxLineSearchIterations);
 
             deck_file_name_ = EWOMS_GET_PARAM(TypeTag, std::string, EclDeckFileName);
         }
@@ -202,6 +304,22 @@ namespace Opm
             EWOMS_REGISTER_PARAM(TypeTag, bool, UpdateEquationsScaling, "Update scaling factors for mass balance equations during the run");
             EWOMS_REGISTER_PARAM(TypeTag, bool, UseUpdateStabilization, "Try to detect and correct oscillations or stagnation during the Newton method");
             EWOMS_REGISTER_PARAM(TypeTag, bool, MatrixAddWellContributions, "Explicitly specify the influences of wells between cells in the Jacobian and preconditioner matrices");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, UseAdaptiveImplicit, "Treat cells away from wells and fronts implicitly in pressure and explicitly in saturations and compositions when solving for the Newton update. Experimental: the linear system keeps its size because the decoupled unknowns become identity rows");
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, AdaptiveImplicitMaxCfl, "Maximum throughput CFL number of a cell which is treated explicitly by the adaptive implicit method");
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, AdaptiveImplicitMaxSaturationChange, "Maximum saturation change of a cell which is treated explicitly by the adaptive implicit method");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, UseLocalNewton, "Solve for the subdomains which violate the CNV criterion with fixed boundary values before each global Newton update");
+            EWOMS_REGISTER_PARAM(TypeTag, int, MaxLocalNewtonIterations, "Maximum number of local Newton iterations before each global Newton update");
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, LocalNewtonMaxCellFraction, "Maximum fraction of cells violating the CNV criterion for which local Newton iterations are done");
+            EWOMS_REGISTER_PARAM(TypeTag, int, LocalNewtonOverlap, "Number of layers of cells added around the cells violating the CNV criterion for the local Newton iterations");
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, LocalNewtonLinearTolerance, "Relative tolerance of the linear solver for the local Newton iterations");
+            EWOMS_REGISTER_PARAM(TypeTag, int, LocalNewtonMaxLinearIterations, "Maximum number of linear iterations for each local Newton iteration");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, UseActiveSetRelinearization, "Only relinearize the cells whose primary variables changed significantly during the last Newton update and their neighbors");
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, ActiveSetRelinearizationTolerance, "Relative change of a primary variable above which its cell is relinearized");
+            EWOMS_REGISTER_PARAM(TypeTag, int, MaxActiveSetLinearizations, "Maximum number of consecutive partial linearizations before the whole reservoir is relinearized");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, UseAndersonAcceleration, "Apply Anderson acceleration to the Newton updates of the reservoir");
+            EWOMS_REGISTER_PARAM(TypeTag, int, AndersonAccelerationDepth, "Number of previous Newton iterations used by Anderson acceleration");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, UseLineSearch, "Halve the last Newton update of the reservoir as long as the residual norms increased");
+            EWOMS_REGISTER_PARAM(TypeTag, int, MaxLineSearchIterations, "Maximum number of times the last Newton update is halved by the line search");
         }
     };
 } // namespace Opm
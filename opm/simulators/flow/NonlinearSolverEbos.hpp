@@ -26,13 +26,22 @@
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/common/Exceptions.hpp>
 #include <opm/simulators/timestepping/SimulatorTimerInterface.hpp>
+#include <opm/simulators/timestepping/NewtonEarlyAbort.hpp>
 
 #include <ewoms/common/parametersystem.hh>
 #include <ewoms/common/propertysystem.hh>
 
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/dynvector.hh>
 #include <dune/common/fmatrix.hh>
 #include <dune/istl/bcrsmatrix.hh>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
 #include <memory>
+#include <string>
+#include <vector>
 
 BEGIN_PROPERTIES
 
@@ -43,11 +52,17 @@ NEW_PROP_TAG(NewtonMaxRelax);
 NEW_PROP_TAG(FlowNewtonMaxIterations);
 NEW_PROP_TAG(FlowNewtonMinIterations);
 NEW_PROP_TAG(NewtonRelaxationType);
+NEW_PROP_TAG(UseNewtonEarlyAbort);
+NEW_PROP_TAG(NewtonEarlyAbortGrowthFactor);
+NEW_PROP_TAG(NewtonEarlyAbortStagnationIterations);
 
 SET_SCALAR_PROP(FlowNonLinearSolver, NewtonMaxRelax, 0.5);
 SET_INT_PROP(FlowNonLinearSolver, FlowNewtonMaxIterations, 20);
 SET_INT_PROP(FlowNonLinearSolver, FlowNewtonMinIterations, 1);
 SET_STRING_PROP(FlowNonLinearSolver, NewtonRelaxationType, "dampen");
+SET_BOOL_PROP(FlowNonLinearSolver, UseNewtonEarlyAbort, false);
+SET_SCALAR_PROP(FlowNonLinearSolver, NewtonEarlyAbortGrowthFactor, 2.0);
+SET_INT_PROP(FlowNonLinearSolver, NewtonEarlyAbortStagnationIterations, 5);
 
 END_PROPERTIES
 
@@ -77,6 +92,9 @@ namespace Opm {
             double relaxRelTol_;
             int maxIter_; // max nonlinear iterations
             int minIter_; // min nonlinear iterations
+            bool earlyAbort_; // abort diverging or stagnating iterations
+            double earlyAbortGrowthFactor_;
+            int earlyAbortStagnationIter_;
 
             SolverParameters()
             {
@@ -87,6 +105,9 @@ namespace Opm {
                 relaxMax_ = EWOMS_GET_PARAM(TypeTag, Scalar, NewtonMaxRelax);
                 maxIter_ = EWOMS_GET_PARAM(TypeTag, int, FlowNewtonMaxIterations);
                 minIter_ = EWOMS_GET_PARAM(TypeTag, int, FlowNewtonMinIterations);
+                earlyAbort_ = EWOMS_GET_PARAM(TypeTag, bool, UseNewtonEarlyAbort);
+                earlyAbortGrowthFactor_ = EWOMS_GET_PARAM(TypeTag, Scalar, NewtonEarlyAbortGrowthFactor);
+                earlyAbortStagnationIter_ = EWOMS_GET_PARAM(TypeTag, int, NewtonEarlyAbortStagnationIterations);
 
                 const auto& relaxationTypeString = EWOMS_GET_PARAM(TypeTag, std::string, NewtonRelaxationType);
                 if (relaxationTypeString == "dampen") {
@@ -104,6 +125,9 @@ namespace Opm {
                 EWOMS_REGISTER_PARAM(TypeTag, int, FlowNewtonMaxIterations, "The maximum number of Newton iterations per time step used by flow");
                 EWOMS_REGISTER_PARAM(TypeTag, int, FlowNewtonMinIterations, "The minimum number of Newton iterations per time step used by flow");
                 EWOMS_REGISTER_PARAM(TypeTag, std::string, NewtonRelaxationType, "The type of relaxation used by flow's Newton method");
+                EWOMS_REGISTER_PARAM(TypeTag, bool, UseNewtonEarlyAbort, "Abort a time step before the iteration limit is reached if the Newton method diverges or stagnates");
+                EWOMS_REGISTER_PARAM(TypeTag, Scalar, NewtonEarlyAbortGrowthFactor, "The factor by which the residual must grow in two consecutive Newton iterations to abort the time step");
+                EWOMS_REGISTER_PARAM(TypeTag, int, NewtonEarlyAbortStagnationIterations, "The number of Newton iterations without any reduction of the residual after which the time step is aborted");
             }
 
             void reset()
@@ -115,6 +139,9 @@ namespace Opm {
                 relaxRelTol_ = 0.2;
                 maxIter_ = 10;
                 minIter_ = 1;
+                earlyAbort_ = false;
+                earlyAbortGrowthFactor_ = 2.0;
+                earlyAbortStagnationIter_ = 5;
             }
 
         };
@@ -178,6 +205,15 @@ namespace Opm {
 
                     converged = report.converged;
                     iteration += 1;
+
+                    // give up early instead of spending the remaining iterations
+                    // if the residuals show that the step is not going to converge
+                    if (!converged && param_.earlyAbort_ && iteration > minIter()) {
+                        std::string msg;
+                        if (detectDivergence(model_->residualNormsHistory(), msg)) {
+                            OPM_THROW_NOLOG(Opm::NewtonEarlyAbort, "Solver convergence failure - " << msg);
+                        }
+                    }
                 }
                 catch (...) {
                     // if an iteration fails during a time step, all previous iterations
@@ -282,6 +318,18 @@ namespace Opm {
         }
 
 
+        /// Detect a diverging or stagnating Newton method in a given residual history,
+        /// see detectNewtonDivergence(). If true is returned, reason describes the
+        /// detected behaviour.
+        bool detectDivergence(const std::vector<std::vector<double>>& residualHistory,
+                              std::string& reason) const
+        {
+            return detectNewtonDivergence(residualHistory,
+                                          param_.earlyAbortGrowthFactor_,
+                                          param_.earlyAbortStagnationIter_,
+                                          reason);
+        }
+
         /// Apply a stabilization to dx, depending on dxOld and relaxation parameters.
         /// Implemention for Dune block vectors.
         template <class BVector>
@@ -323,6 +371,97 @@ namespace Opm {
             return;
         }
 
+        /// Apply Anderson acceleration to the Newton update dx.
+        /// dxHistory holds the Newton updates of the previous iterations and
+        /// appliedHistory the updates which were subsequently applied to the solution.
+        /// At most depth previous iterations are used; dx is appended to dxHistory
+        /// before it gets modified.
+        template <class BVector>
+        void accelerateNonlinearUpdate(BVector& dx,
+                                       std::vector<BVector>& dxHistory,
+                                       std::vector<BVector>& appliedHistory,
+                                       const int depth) const
+        {
+            assert(dxHistory.size() == appliedHistory.size());
+            while (static_cast<int>(dxHistory.size()) > depth) {
+                dxHistory.erase(dxHistory.begin());
+                appliedHistory.erase(appliedHistory.begin());
+            }
+
+            const BVector newtonDx = dx;
+            const int m = dxHistory.size();
+            if (m > 0) {
+                // the primary variables are of very different magnitude, so each of
+                // them is scaled by the largest entry of the current Newton update
+                typedef typename BVector::block_type Block;
+                Block weight(0.0);
+                for (const auto& block : dx) {
+                    for (std::size_t pvIdx = 0; pvIdx < block.size(); ++pvIdx) {
+                        weight[pvIdx] = std::max(weight[pvIdx], std::abs(block[pvIdx]));
+                    }
+                }
+                for (auto& w : weight) {
+                    w = (w > 0.0) ? 1.0/w : 0.0;
+                }
+                const auto weightedDot = [&weight](const BVector& a, const BVector& b)
+                {
+                    double result = 0.0;
+                    for (std::size_t i = 0; i < a.size(); ++i) {
+                        for (std::size_t pvIdx = 0; pvIdx < a[i].size(); ++pvIdx) {
+                            result += a[i][pvIdx]*b[i][pvIdx]*weight[pvIdx]*weight[pvIdx];
+                        }
+                    }
+                    return result;
+                };
+
+                // differences of the consecutive Newton updates
+                std::vector<BVector> dF(m);
+                for (int i = 0; i < m; ++i) {
+                    dF[i] = (i + 1 < m) ? dxHistory[i + 1] : dx;
+                    dF[i] -= dxHistory[i];
+                }
+
+                // least squares fit of the current update by the differences
+                Dune::DynamicMatrix<double> A(m, m);
+                Dune::DynamicVector<double> b(m);
+                Dune::DynamicVector<double> gamma(m);
+                double trace = 0.0;
+                for (int i = 0; i < m; ++i) {
+                    for (int j = 0; j <= i; ++j) {
+                        A[i][j] = A[j][i] = weightedDot(dF[i], dF[j]);
+                    }
+                    b[i] = weightedDot(dF[i], dx);
+                    trace += A[i][i];
+                }
+                for (int i = 0; i < m; ++i) {
+                    A[i][i] += 1e-10*trace;
+                }
+
+                bool solved = trace > 0.0;
+                if (solved) {
+                    try {
+                        A.solve(gamma, b);
+                    }
+                    catch (const Dune::FMatrixError&) {
+                        solved = false;
+                    }
+                }
+                for (int i = 0; i < m && solved; ++i) {
+                    solved = std::isfinite(gamma[i]);
+                }
+
+                // dx -= sum_i gamma_i*(applied_i + dF_i)
+                if (solved) {
+                    for (int i = 0; i < m; ++i) {
+                        dx.axpy(-gamma[i], appliedHistory[i]);
+                        dx.axpy(-gamma[i], dF[i]);
+                    }
+                }
+            }
+
+            dxHistory.push_back(newtonDx);
+        }
+
         /// The greatest relaxation factor (i.e. smallest factor) allowed.
         double relaxMax() const
         { return param_.relaxMax_; }
@@ -28,6 +28,7 @@
 #include <opm/simulators/wells/WellStateFullyImplicitBlackoil.hpp>
 #include <opm/simulators/aquifers/BlackoilAquiferModel.hpp>
 #include <opm/simulators/utils/moduleVersion.hpp>
+#include <opm/simulators/utils/BinaryCheckpoint.hpp>
 #include <opm/simulators/timestepping/AdaptiveTimeSteppingEbos.hpp>
 #include <opm/grid/utility/StopWatch.hpp>
 
@@ -39,10 +40,14 @@ BEGIN_PROPERTIES
 NEW_PROP_TAG(EnableTerminalOutput);
 NEW_PROP_TAG(EnableAdaptiveTimeStepping);
 NEW_PROP_TAG(EnableTuning);
+NEW_PROP_TAG(CheckpointInterval);
+NEW_PROP_TAG(LoadCheckpoint);
 
 SET_BOOL_PROP(EclFlowProblem, EnableTerminalOutput, true);
 SET_BOOL_PROP(EclFlowProblem, EnableAdaptiveTimeStepping, true);
 SET_BOOL_PROP(EclFlowProblem, EnableTuning, false);
+SET_INT_PROP(EclFlowProblem, CheckpointInterval, 0);
+SET_STRING_PROP(EclFlowProblem, LoadCheckpoint, "");
 
 END_PROPERTIES
 
@@ -120,6 +125,10 @@ public:
                              "Use adaptive time stepping between report steps");
         EWOMS_REGISTER_PARAM(TypeTag, bool, EnableTuning,
                              "Honor some aspects of the TUNING keyword.");
+        EWOMS_REGISTER_PARAM(TypeTag, int, CheckpointInterval,
+                             "Write a binary checkpoint after every n-th report step (0: never)");
+        EWOMS_REGISTER_PARAM(TypeTag, std::string, LoadCheckpoint,
+                             "Resume the simulation from the binary checkpoint of the given name");
     }
 
     /// Run the simulation.
@@ -134,9 +143,13 @@ public:
 
         ebosSimulator_.setEpisodeIndex(-1);
 
+        // a binary checkpoint replaces the restart from the ECL restart file
+        const std::string checkpointName = EWOMS_GET_PARAM(TypeTag, std::string, LoadCheckpoint);
+        const bool eclRestart = isRestart() && checkpointName.empty();
+
         // handle restarts
         std::unique_ptr<RestartValue> restartValues;
-        if (isRestart()) {
+        if (eclRestart) {
             Opm::SummaryState& summaryState = ebosSimulator_.vanguard().summaryState();
             std::vector<RestartKey> extraKeys = {
                 {"OPMEXTRA" , Opm::UnitSystem::measure::identity, false}
@@ -165,7 +178,7 @@ public:
             }
 
             double suggestedStepSize = -1.0;
-            if (isRestart()) {
+            if (eclRestart) {
                 // This is a restart, determine the time step size from the restart data
                 if (restartValues->hasExtra("OPMEXTRA")) {
                     std::vector<double> opmextra = restartValues->getExtra("OPMEXTRA");
@@ -186,7 +199,7 @@ public:
         SimulatorReport report;
         SimulatorReport stepReport;
 
-        if (isRestart()) {
+        if (eclRestart) {
             // Set the start time of the simulation
             const auto& schedule = ebosSimulator_.vanguard().schedule();
             const auto& eclState = ebosSimulator_.vanguard().eclState();
@@ -204,6 +217,14 @@ public:
             wellModel_().initFromRestartFile(*restartValues);
         }
 
+        if (!checkpointName.empty()) {
+            Dune::Timer perfTimer;
+            perfTimer.start();
+            loadCheckpoint_(checkpointName, timer, adaptiveTimeStepping.get());
+            report.output_write_time += perfTimer.stop();
+        }
+        const int checkpointInterval = EWOMS_GET_PARAM(TypeTag, int, CheckpointInterval);
+
         // Main simulation loop.
         while (!timer.done()) {
             // Report timestep.
@@ -302,6 +323,12 @@ public:
             // Increment timer, remember well state.
             ++timer;
 
+            if (checkpointInterval > 0 && !timer.done() && timer.currentStepNum() % checkpointInterval == 0) {
+                perfTimer.reset();
+                perfTimer.start();
+                writeCheckpoint_(timer, adaptiveTimeStepping.get());
+                report.output_write_time += perfTimer.stop();
+            }
 
             if (terminalOutput_) {
                 if (!timer.initialStep()) {
@@ -377,6 +404,130 @@ protected:
     WellModel& wellModel_()
     { return ebosSimulator_.problem().wellModel(); }
 
+    // Each process writes the checkpoint of its part of the grid to its own file.
+    std::string checkpointFileName_(const std::string& checkpointName) const
+    { return checkpointName + "." + std::to_string(grid().comm().rank()); }
+
+    // Write the state at the beginning of the current report step to a binary
+    // checkpoint. The name of the checkpoint is given by the case name and the
+    // report step.
+    void writeCheckpoint_(const SimulatorTimer& timer, TimeStepper* adaptiveTimeStepping)
+    {
+        const auto& ioConfig = eclState().getIOConfig();
+        std::ostringstream checkpointName;
+        checkpointName << ioConfig.getOutputDir() << "/" << ioConfig.getBaseName()
+                       << ".CHKP" << std::setw(4) << std::setfill('0') << timer.currentStepNum();
+
+        CheckpointWriter writer(checkpointFileName_(checkpointName.str()));
+        int reportStep = timer.currentStepNum();
+        writer.value("reportStep", reportStep);
+        checkpointReservoir_(writer);
+        wellModel_().checkpoint(writer);
+        if (adaptiveTimeStepping) {
+            adaptiveTimeStepping->checkpoint(writer);
+        }
+        writer.commit();
+
+        if (terminalOutput_) {
+            OpmLog::info("Checkpoint written: " + checkpointName.str());
+        }
+    }
+
+    // Restore the state from a binary checkpoint and continue with the report step
+    // at which it was written.
+    void loadCheckpoint_(const std::string& checkpointName,
+                         SimulatorTimer& timer,
+                         TimeStepper* adaptiveTimeStepping)
+    {
+        CheckpointReader reader(checkpointFileName_(checkpointName));
+        int reportStep = 0;
+        reader.value("reportStep", reportStep);
+        if (reportStep < 1 || reportStep >= timer.numSteps()) {
+            OPM_THROW(std::runtime_error, "Checkpoint " << checkpointName << " was written at report step "
+                      << reportStep << " which is not part of this simulation");
+        }
+        timer.setCurrentStepNum(reportStep);
+
+        checkpointReservoir_(reader);
+
+        // the wells of the report step at the end of which the checkpoint was written
+        // need to be set up before their state can be restored
+        const auto& timeMap = schedule().getTimeMap();
+        const int episodeIdx = reportStep - 1;
+        ebosSimulator_.setStartTime(timeMap.getStartTime(/*timeStepIdx=*/0));
+        ebosSimulator_.setTime(timeMap.getTimePassedUntil(episodeIdx));
+        ebosSimulator_.startNextEpisode(ebosSimulator_.startTime() + ebosSimulator_.time(),
+                                        timeMap.getTimeStepLength(episodeIdx));
+        ebosSimulator_.setEpisodeIndex(episodeIdx);
+        wellModel_().beginEpisode();
+        wellModel_().checkpoint(reader);
+
+        if (adaptiveTimeStepping) {
+            adaptiveTimeStepping->checkpoint(reader);
+        }
+
+        if (terminalOutput_) {
+            OpmLog::info("Simulation resumed from checkpoint " + checkpointName
+                         + " at report step " + std::to_string(reportStep));
+        }
+    }
+
+    // The primary variables and the state of the problem. Since the storage terms
+    // and the intensive quantities are computed from these, they are recomputed
+    // when the simulation is resumed.
+    template <class Serializer>
+    void checkpointReservoir_(Serializer& serializer)
+    {
+        // the grid must be distributed in the same way as when the checkpoint was
+        // written
+        const int numProcs = grid().comm().size();
+        int checkpointNumProcs = numProcs;
+        serializer.value("numProcesses", checkpointNumProcs);
+        if (checkpointNumProcs != numProcs) {
+            OPM_THROW(std::runtime_error, "Checkpoint was written by " << checkpointNumProcs
+                      << " processes, but the simulation runs on " << numProcs);
+        }
+
+        auto& model = ebosSimulator_.model();
+        auto& solution = model.solution(/*timeIdx=*/0);
+        const size_t numDof = model.numGridDof();
+        const size_t numEq = BlackoilIndices::numEq;
+        std::vector<double> values(numDof*numEq);
+        std::vector<int> meanings(numDof);
+        for (size_t dofIdx = 0; dofIdx < numDof; ++dofIdx) {
+            for (size_t eqIdx = 0; eqIdx < numEq; ++eqIdx) {
+                values[dofIdx*numEq + eqIdx] = solution[dofIdx][eqIdx];
+            }
+            meanings[dofIdx] = static_cast<int>(solution[dofIdx].primaryVarsMeaning());
+        }
+
+        serializer.vector("solution/values", values);
+        serializer.vector("solution/meanings", meanings);
+
+        if (serializer.isReading()) {
+            typedef typename PrimaryVariables::PrimaryVarsMeaning PrimaryVarsMeaning;
+            for (size_t dofIdx = 0; dofIdx < numDof; ++dofIdx) {
+                for (size_t eqIdx = 0; eqIdx < numEq; ++eqIdx) {
+                    solution[dofIdx][eqIdx] = values[dofIdx*numEq + eqIdx];
+                }
+                solution[dofIdx].setPrimaryVarsMeaning(static_cast<PrimaryVarsMeaning>(meanings[dofIdx]));
+            }
+            model.solution(/*timeIdx=*/1) = solution;
+            model.invalidateIntensiveQuantitiesCache(/*timeIdx=*/0);
+            model.invalidateIntensiveQuantitiesCache(/*timeIdx=*/1);
+        }
+
+        // the cumulative quantities of the summary output
+        auto& summaryState = ebosSimulator_.vanguard().summaryState();
+        std::vector<char> summaryBuffer = summaryState.serialize();
+        serializer.dynamicVector("summaryState", summaryBuffer);
+        if (serializer.isReading()) {
+            summaryState.deserialize(summaryBuffer);
+        }
+
+        ebosSimulator_.problem().checkpoint(serializer);
+    }
+
     const WellModel& wellModel_() const
     { return ebosSimulator_.problem().wellModel(); }
 
@@ -0,0 +1,181 @@
+/*
+  Copyright 2019 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_ADAPTIVE_IMPLICIT_SYSTEM_HEADER_INCLUDED
+#define OPM_ADAPTIVE_IMPLICIT_SYSTEM_HEADER_INCLUDED
+
+#include <dune/common/fmatrix.hh>
+
+#include <vector>
+
+namespace Opm
+{
+
+    /// Reduction of a linearized system with block rows per cell to the adaptive
+    /// implicit formulation, in which some cells are treated implicitly in pressure
+    /// and explicitly in all other primary variables.
+    ///
+    /// The fluxes are assumed to be independent of the saturations and compositions
+    /// of the explicit cells, so the corresponding columns of their neighbors' blocks
+    /// are dropped. The block row of an explicit cell, including its entry of the
+    /// right hand side, is then scaled by the inverse of its diagonal block. Its
+    /// pressure row stays in the system, while the remaining rows are decoupled and
+    /// recovered after the linear solve. Note that the size of the system does not
+    /// change: the decoupled rows become identity rows.
+    template <class Matrix, class Vector>
+    class AdaptiveImplicitSystem
+    {
+    public:
+        typedef typename Matrix::block_type MatrixBlockType;
+        typedef typename Vector::block_type VectorBlockType;
+        enum { numEq = VectorBlockType::dimension };
+
+        /// Modify the matrix and the right hand side for the cells flagged as
+        /// explicit. Returns false and leaves the system untouched if there are none.
+        bool reduce(Matrix& matrix,
+                    Vector& rhs,
+                    const std::vector<bool>& isExplicit,
+                    const int pressureIdx)
+        {
+            // the buffers keep their memory between the Newton iterations
+            cells_.clear();
+            rowOffsets_.assign(1, 0);
+            columns_.clear();
+            blocks_.clear();
+            scaledRhs_.clear();
+            originalRhs_.clear();
+            pressureIdx_ = pressureIdx;
+
+            bool anyExplicit = false;
+            for (const bool cellIsExplicit : isExplicit) {
+                anyExplicit = anyExplicit || cellIsExplicit;
+            }
+            if (!anyExplicit) {
+                return false;
+            }
+
+            for (auto row = matrix.begin(); row != matrix.end(); ++row) {
+                for (auto col = row->begin(); col != row->end(); ++col) {
+                    if (col.index() == row.index() || !isExplicit[col.index()]) {
+                        continue;
+                    }
+
+                    auto& block = *col;
+                    for (int eqIdx = 0; eqIdx < numEq; ++eqIdx) {
+                        for (int pvIdx = 0; pvIdx < numEq; ++pvIdx) {
+                            if (pvIdx != pressureIdx) {
+                                block[eqIdx][pvIdx] = 0.0;
+                            }
+                        }
+                    }
+                }
+            }
+
+            for (auto row = matrix.begin(); row != matrix.end(); ++row) {
+                const unsigned cellIdx = row.index();
+                if (!isExplicit[cellIdx]) {
+                    continue;
+                }
+
+                MatrixBlockType diagInv = matrix[cellIdx][cellIdx];
+                try {
+                    diagInv.invert();
+                }
+                catch (const Dune::FMatrixError&) {
+                    // keep the row of the cell as it is. this is still consistent
+                    // because only the couplings to the neighbors were dropped.
+                    continue;
+                }
+
+                for (auto col = row->begin(); col != row->end(); ++col) {
+                    auto& block = *col;
+                    if (col.index() == cellIdx) {
+                        block = 0.0;
+                        for (int eqIdx = 0; eqIdx < numEq; ++eqIdx) {
+                            block[eqIdx][eqIdx] = 1.0;
+                        }
+                        continue;
+                    }
+
+                    block.leftmultiply(diagInv);
+                    columns_.push_back(col.index());
+                    blocks_.push_back(block);
+                    for (int eqIdx = 0; eqIdx < numEq; ++eqIdx) {
+                        if (eqIdx != pressureIdx) {
+                            block[eqIdx] = 0.0;
+                        }
+                    }
+                }
+
+                VectorBlockType scaledRhs;
+                diagInv.mv(rhs[cellIdx], scaledRhs);
+                scaledRhs_.push_back(scaledRhs);
+                originalRhs_.push_back(rhs[cellIdx]);
+                rhs[cellIdx] = 0.0;
+                rhs[cellIdx][pressureIdx] = scaledRhs[pressureIdx];
+
+                cells_.push_back(cellIdx);
+                rowOffsets_.push_back(columns_.size());
+            }
+
+            return true;
+        }
+
+        /// Recover the update of the saturations and compositions of the explicit
+        /// cells from the solution of the reduced system.
+        void recover(Vector& x) const
+        {
+            for (unsigned i = 0; i < cells_.size(); ++i) {
+                VectorBlockType dx = scaledRhs_[i];
+                for (unsigned k = rowOffsets_[i]; k < rowOffsets_[i + 1]; ++k) {
+                    blocks_[k].mmv(x[columns_[k]], dx);
+                }
+
+                const unsigned cellIdx = cells_[i];
+                const auto dp = x[cellIdx][pressureIdx_];
+                x[cellIdx] = dx;
+                x[cellIdx][pressureIdx_] = dp;
+            }
+        }
+
+        /// Undo the modification of the right hand side by reduce().
+        void restoreRhs(Vector& rhs) const
+        {
+            for (unsigned i = 0; i < cells_.size(); ++i) {
+                rhs[cells_[i]] = originalRhs_[i];
+            }
+        }
+
+    private:
+        int pressureIdx_ = 0;
+
+        // the explicit cells, their scaled off-diagonal blocks and right hand sides
+        std::vector<unsigned> cells_;
+        std::vector<unsigned> rowOffsets_;
+        std::vector<unsigned> columns_;
+        std::vector<MatrixBlockType> blocks_;
+        std::vector<VectorBlockType> scaledRhs_;
+
+        // the unscaled right hand side of the explicit cells
+        std::vector<VectorBlockType> originalRhs_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_ADAPTIVE_IMPLICIT_SYSTEM_HEADER_INCLUDED
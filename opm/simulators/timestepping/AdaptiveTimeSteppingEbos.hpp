@@ -3,8 +3,10 @@
 #ifndef OPM_ADAPTIVE_TIME_STEPPING_EBOS_HPP
 #define OPM_ADAPTIVE_TIME_STEPPING_EBOS_HPP
 
+#include <cmath>
 #include <iostream>
 #include <utility>
+#include <vector>
 
 #include <opm/simulators/timestepping/SimulatorReport.hpp>
 #include <opm/grid/utility/StopWatch.hpp>
@@ -15,6 +17,7 @@
 #include <opm/simulators/timestepping/AdaptiveSimulatorTimer.hpp>
 #include <opm/simulators/timestepping/TimeStepControlInterface.hpp>
 #include <opm/simulators/timestepping/TimeStepControl.hpp>
+#include <opm/simulators/timestepping/NewtonEarlyAbort.hpp>
 #include <opm/core/props/phaseUsageFromDeck.hpp>
 
 BEGIN_PROPERTIES
@@ -160,7 +163,7 @@ namespace Opm {
             EWOMS_REGISTER_PARAM(TypeTag, double, TimeStepAfterEventInDays,
                                  "Time step size of the first time step after an event occurs during the simulation in days");
             EWOMS_REGISTER_PARAM(TypeTag, std::string, TimeStepControl,
-                                 "The algorithm used to determine time-step sizes. valid options are: 'pid' (default), 'pid+iteration', 'pid+newtoniteration', 'iterationcount' and 'hardcoded'");
+                                 "The algorithm used to determine time-step sizes. valid options are: 'pid' (default), 'pid+iteration', 'pid+newtoniteration', 'convergencerate', 'iterationcount' and 'hardcoded'");
             EWOMS_REGISTER_PARAM(TypeTag, double, TimeStepControlTolerance,
                                  "The tolerance used by the time step size control algorithm");
             EWOMS_REGISTER_PARAM(TypeTag, int, TimeStepControlTargetIterations,
@@ -215,6 +218,14 @@ namespace Opm {
 
             // sub step time loop
             while (!substepTimer.done()) {
+                // let the time step control reduce the step size if it predicts that the
+                // step would not converge
+                const double dtLimited = timeStepControl_->limitTimeStepSize(substepTimer.currentStepLength());
+                if (dtLimited < substepTimer.currentStepLength()) {
+                    substepTimer.provideTimeStepEstimate(dtLimited);
+                    ebosProblem.setNextTimeStepSize(substepTimer.currentStepLength());
+                }
+
                 // get current delta t
                 const double dt = substepTimer.currentStepLength() ;
                 if (timestepVerbose_) {
@@ -240,6 +251,13 @@ namespace Opm {
                         OpmLog::debug("Overall linear iterations used: " + std::to_string(substepReport.total_linear_iterations));
                     }
                 }
+                catch (const Opm::NewtonEarlyAbort& e) {
+                    substepReport += solver.failureReport();
+                    causeOfFailure = "Solver convergence failure - Newton method diverges or stagnates";
+
+                    logException_(e, solverVerbose_);
+                    // since linearIterations is < 0 this will restart the solver
+                }
                 catch (const Opm::TooManyIterations& e) {
                     substepReport += solver.failureReport();
                     causeOfFailure = "Solver convergence failure - Iteration limit reached";
@@ -280,6 +298,9 @@ namespace Opm {
                     // this can be thrown by ISTL's ILU0 in block mode, yet is not an ISTLError
                 }
 
+                // let the time step control learn from the convergence of the nonlinear solver
+                timeStepControl_->recordConvergenceHistory(dt, scaledResidualHistory_(solver), substepReport.converged);
+
                 if (substepReport.converged) {
                     // advance by current dt
                     ++substepTimer;
@@ -449,6 +470,26 @@ namespace Opm {
             timestepAfterEvent_ = tuning.getTMAXWC(timeStep);
         }
 
+        /// Write the state of the time stepping to a binary checkpoint or read it
+        /// from one, see CheckpointWriter. This includes the parameters which may
+        /// have been changed by the TUNING keyword.
+        template <class Serializer>
+        void checkpoint(Serializer& serializer)
+        {
+            serializer.value("timestepping/suggestedNextTimestep", suggestedNextTimestep_);
+            serializer.value("timestepping/restartFactor", restartFactor_);
+            serializer.value("timestepping/growthFactor", growthFactor_);
+            serializer.value("timestepping/maxGrowth", maxGrowth_);
+            serializer.value("timestepping/maxTimeStep", maxTimeStep_);
+            serializer.value("timestepping/timestepAfterEvent", timestepAfterEvent_);
+
+            std::vector<double> controlState = timeStepControl_->state();
+            serializer.dynamicVector("timestepping/control", controlState);
+            if (serializer.isReading()) {
+                timeStepControl_->setState(controlState);
+            }
+        }
+
 
     protected:
         void init_()
@@ -469,6 +510,11 @@ namespace Opm {
                 timeStepControl_ = TimeStepControlType(new PIDAndIterationCountTimeStepControl(iterations, tol));
                 useNewtonIteration_ = true;
             }
+            else if (control == "convergencerate") {
+                const int iterations =  EWOMS_GET_PARAM(TypeTag, int, TimeStepControlTargetNewtonIterations); // 8
+                timeStepControl_ = TimeStepControlType(new ConvergenceRateTimeStepControl(iterations, tol));
+                useNewtonIteration_ = true;
+            }
             else if (control == "iterationcount") {
                 const int iterations =  EWOMS_GET_PARAM(TypeTag, int, TimeStepControlTargetIterations); // 30
                 const double decayrate = EWOMS_GET_PARAM(TypeTag, double, TimeStepControlDecayRate); // 0.75
@@ -488,6 +534,26 @@ namespace Opm {
         }
 
 
+        // the largest CNV residual norm of each nonlinear iteration of the last step
+        // relative to the convergence tolerance
+        template <class Solver>
+        std::vector<double> scaledResidualHistory_(const Solver& solver) const
+        {
+            const auto& model = solver.model();
+            const double tolerance = model.param().tolerance_cnv_;
+            std::vector<double> residuals;
+            residuals.reserve(model.residualNormsHistory().size());
+            for (const auto& norms : model.residualNormsHistory()) {
+                double maxNorm = 0.0;
+                for (const double norm : norms) {
+                    // propagate NaNs
+                    maxNorm = (std::isnan(norm) || norm > maxNorm) ? norm : maxNorm;
+                }
+                residuals.push_back(maxNorm/tolerance);
+            }
+            return residuals;
+        }
+
         template <class StepReportVector>
         std::set<std::string> consistentlyFailingWells(const StepReportVector& sr)
         {
@@ -0,0 +1,64 @@
+/*
+  Copyright 2019 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#include <opm/simulators/timestepping/NewtonEarlyAbort.hpp>
+
+#include <algorithm>
+
+namespace Opm
+{
+
+    bool detectNewtonDivergence(const std::vector<std::vector<double>>& residualHistory,
+                                const double growthFactor,
+                                const int stagnationIter,
+                                std::string& reason)
+    {
+        const int numIter = residualHistory.size();
+        const auto residual = [&residualHistory](const int it)
+        {
+            const auto& norms = residualHistory[it];
+            return norms.empty() ? 0.0 : *std::max_element(norms.begin(), norms.end());
+        };
+
+        if (numIter >= 3 && growthFactor > 1.0) {
+            const double r0 = residual(numIter - 3);
+            const double r1 = residual(numIter - 2);
+            const double r2 = residual(numIter - 1);
+            if (r0 > 0.0 && r1 > growthFactor*r0 && r2 > growthFactor*r1) {
+                reason = "Residual grew from " + std::to_string(r0) + " to " + std::to_string(r2)
+                    + " in the last two iterations.";
+                return true;
+            }
+        }
+
+        if (stagnationIter > 0 && numIter > stagnationIter) {
+            const double rOld = residual(numIter - 1 - stagnationIter);
+            const double rNew = residual(numIter - 1);
+            if (rOld > 0.0 && rNew >= rOld) {
+                reason = "Residual was not reduced in the last " + std::to_string(stagnationIter) + " iterations.";
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+} // namespace Opm
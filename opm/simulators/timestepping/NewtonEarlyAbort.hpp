@@ -0,0 +1,58 @@
+/*
+  Copyright 2019 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_NEWTON_EARLY_ABORT_HEADER_INCLUDED
+#define OPM_NEWTON_EARLY_ABORT_HEADER_INCLUDED
+
+#include <opm/common/Exceptions.hpp>
+
+#include <string>
+#include <vector>
+
+namespace Opm
+{
+
+    /// Thrown by the nonlinear solver if the residual history shows that the
+    /// Newton method diverges or stagnates, i.e., before the iteration limit is
+    /// reached. It is a TooManyIterations exception, so code which does not
+    /// care about the distinction treats it as a regular convergence failure.
+    class NewtonEarlyAbort : public Opm::TooManyIterations
+    {
+    public:
+        explicit NewtonEarlyAbort(const std::string& message)
+            : Opm::TooManyIterations(message)
+        {}
+    };
+
+    /// Detect a diverging or stagnating Newton method in a given residual history.
+    /// The residual of an iteration is the largest of its residual norms. The
+    /// method diverges if the residual grew by more than growthFactor in each of
+    /// the last two iterations and stagnates if the residual of the last iteration
+    /// is not smaller than the one stagnationIter iterations before. A growth
+    /// factor which is not larger than one or a non-positive number of iterations
+    /// disables the respective check. If true is returned, reason describes the
+    /// detected behaviour.
+    bool detectNewtonDivergence(const std::vector<std::vector<double>>& residualHistory,
+                                const double growthFactor,
+                                const int stagnationIter,
+                                std::string& reason);
+
+} // namespace Opm
+
+#endif // OPM_NEWTON_EARLY_ABORT_HEADER_INCLUDED
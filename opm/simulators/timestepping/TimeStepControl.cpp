@@ -19,9 +19,11 @@
   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include <config.h>
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <iostream>
+#include <limits>
 #include <stdexcept>
 #include <string>
 #include <fstream>
@@ -158,6 +160,21 @@ namespace Opm
         }
     }
 
+    std::vector<double> PIDTimeStepControl::
+    state() const
+    {
+        return errors_;
+    }
+
+    void PIDTimeStepControl::
+    setState( const std::vector<double>& state )
+    {
+        if( state.size() != errors_.size() ) {
+            OPM_THROW(std::runtime_error,"PIDTimeStepControl: invalid state of size " << state.size() );
+        }
+        errors_ = state;
+    }
+
 
 
     ////////////////////////////////////////////////////////////
@@ -193,4 +210,123 @@ namespace Opm
         return std::min(dtEstimatePID, dtEstimateIter);
     }
 
+
+
+    ////////////////////////////////////////////////////////////
+    //
+    //  ConvergenceRateTimeStepControl  Implementation
+    //
+    ////////////////////////////////////////////////////////////
+
+    ConvergenceRateTimeStepControl::
+    ConvergenceRateTimeStepControl( const int target_iterations,
+                                    const double tol,
+                                    const int history_size,
+                                    const bool verbose)
+        : BaseType( target_iterations, tol, verbose )
+        , history_size_( history_size )
+    {
+        if( history_size_ < 1 ) {
+            OPM_THROW(std::runtime_error,"ConvergenceRateTimeStepControl: history size should be >= 1 " << history_size_ );
+        }
+    }
+
+    double ConvergenceRateTimeStepControl::
+    computeTimeStepSize( const double dt, const int iterations, const RelativeChangeInterface& relChange, const double simulationTimeElapsed ) const
+    {
+        const double dtEstimate = BaseType :: computeTimeStepSize( dt, iterations, relChange, simulationTimeElapsed );
+        return limitTimeStepSize( dtEstimate );
+    }
+
+    void ConvergenceRateTimeStepControl::
+    recordConvergenceHistory( const double dt, const std::vector<double>& residuals, const bool converged )
+    {
+        StepRecord record;
+        record.dt = dt;
+        record.initialResidual = residuals.empty() ? 0.0 : residuals.front();
+        record.contractionRate = 1.0;
+        record.converged = converged;
+
+        const bool usable = residuals.size() >= 2
+            && residuals.front() > 0.0 && std::isfinite( residuals.front() )
+            && residuals.back() > 0.0 && std::isfinite( residuals.back() );
+        if( usable ) {
+            // geometric mean of the reduction of the residuals per iteration
+            const double numIterations = residuals.size() - 1;
+            record.contractionRate = std::pow( residuals.back() / residuals.front(), 1.0 / numIterations );
+        }
+        else if( converged ) {
+            // nothing to learn from a step which converged without iterations
+            return;
+        }
+
+        history_.push_back( record );
+        if( int(history_.size()) > history_size_ ) {
+            history_.erase( history_.begin() );
+        }
+    }
+
+    double ConvergenceRateTimeStepControl::
+    limitTimeStepSize( const double dt ) const
+    {
+        const double dtMax = predictedMaxTimeStepSize();
+        if( verbose_ && dtMax < dt )
+            std::cout << "Step size limited by the convergence rate: " << unit::convert::to( dtMax, unit::day ) << " (days)" << std::endl;
+        return std::min( dt, dtMax );
+    }
+
+    double ConvergenceRateTimeStepControl::
+    predictedMaxTimeStepSize() const
+    {
+        double dtMax = std::numeric_limits<double>::max();
+        for( const auto& record : history_ ) {
+            if( !record.converged ) {
+                // do not try the size of a recently failed step again
+                dtMax = std::min( dtMax, 0.75 * record.dt );
+            }
+            else if( record.initialResidual > 1.0 && record.contractionRate < 1.0 ) {
+                // the residual after n iterations is about r0 * (dt/dt_i) * rate^n,
+                // which should drop below one within the target iterations
+                const double reduction = std::pow( record.contractionRate, target_iterations_ );
+                dtMax = std::min( dtMax, record.dt / ( record.initialResidual * reduction ) );
+            }
+        }
+
+        return dtMax;
+    }
+
+    std::vector<double> ConvergenceRateTimeStepControl::
+    state() const
+    {
+        // the errors of the PID controller followed by the step records
+        std::vector<double> result = BaseType :: state();
+        for( const auto& record : history_ ) {
+            result.push_back( record.dt );
+            result.push_back( record.initialResidual );
+            result.push_back( record.contractionRate );
+            result.push_back( record.converged ? 1.0 : 0.0 );
+        }
+        return result;
+    }
+
+    void ConvergenceRateTimeStepControl::
+    setState( const std::vector<double>& state )
+    {
+        const std::size_t numErrors = errors_.size();
+        if( state.size() < numErrors || ( state.size() - numErrors ) % 4 != 0 ) {
+            OPM_THROW(std::runtime_error,"ConvergenceRateTimeStepControl: invalid state of size " << state.size() );
+        }
+        BaseType :: setState( std::vector<double>( state.begin(), state.begin() + numErrors ) );
+
+        history_.clear();
+        for( std::size_t i = numErrors; i < state.size(); i += 4 ) {
+            StepRecord record;
+            record.dt = state[ i ];
+            record.initialResidual = state[ i + 1 ];
+            record.contractionRate = state[ i + 2 ];
+            record.converged = state[ i + 3 ] != 0.0;
+            history_.push_back( record );
+        }
+    }
+
 } // end namespace Opm
@@ -84,6 +84,12 @@ namespace Opm
         /// \brief \copydoc TimeStepControlInterface::computeTimeStepSize
         double computeTimeStepSize( const double dt, const int /* iterations */, const RelativeChangeInterface& relativeChange, const double /*simulationTimeElapsed */ ) const;
 
+        /// \brief \copydoc TimeStepControlInterface::state
+        std::vector<double> state() const;
+
+        /// \brief \copydoc TimeStepControlInterface::setState
+        void setState( const std::vector<double>& state );
+
     protected:
         const double tol_;
         mutable std::vector< double > errors_;
@@ -117,6 +123,63 @@ namespace Opm
         const int     target_iterations_;
     };
 
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///  Time step control which learns how fast the residuals of the Newton method
+    ///  contracted during the recent steps. A step is limited to the size for which
+    ///  the residuals are predicted to converge within the target number of
+    ///  iterations, assuming that the initial residual grows linearly with the step
+    ///  size. Step sizes which failed recently are not attempted again. Otherwise the
+    ///  time step size is determined as by PIDAndIterationCountTimeStepControl.
+    //
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    class ConvergenceRateTimeStepControl : public PIDAndIterationCountTimeStepControl
+    {
+        typedef PIDAndIterationCountTimeStepControl BaseType;
+    public:
+        /// \brief constructor
+        /// \param target_iterations  number of Newton iterations within which a step should converge
+        /// \param tol                tolerance for the relative changes of the numerical solution to be accepted
+        ///                           in one time step (default is 1e-1)
+        /// \param history_size       number of recent steps from which the convergence rates are learned
+        /// \param verbose            if true get some output (default = false)
+        ConvergenceRateTimeStepControl( const int target_iterations = 8,
+                                        const double tol = 1e-1,
+                                        const int history_size = 5,
+                                        const bool verbose = false );
+
+        /// \brief \copydoc TimeStepControlInterface::computeTimeStepSize
+        double computeTimeStepSize( const double dt, const int iterations, const RelativeChangeInterface& relativeChange, const double simulationTimeElapsed ) const;
+
+        /// \brief \copydoc TimeStepControlInterface::recordConvergenceHistory
+        void recordConvergenceHistory( const double dt, const std::vector<double>& residuals, const bool converged );
+
+        /// \brief \copydoc TimeStepControlInterface::limitTimeStepSize
+        double limitTimeStepSize( const double dt ) const;
+
+        /// \brief \copydoc TimeStepControlInterface::state
+        std::vector<double> state() const;
+
+        /// \brief \copydoc TimeStepControlInterface::setState
+        void setState( const std::vector<double>& state );
+
+        /// \return the largest time step size which is predicted to converge within
+        ///         the target number of iterations
+        double predictedMaxTimeStepSize() const;
+
+    protected:
+        struct StepRecord
+        {
+            double dt;
+            double initialResidual;
+            double contractionRate;
+            bool converged;
+        };
+
+        const int history_size_;
+        std::vector< StepRecord > history_;
+    };
+
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
     ///
     ///  HardcodedTimeStepControl
@@ -19,6 +19,8 @@
 #ifndef OPM_TIMESTEPCONTROLINTERFACE_HEADER_INCLUDED
 #define OPM_TIMESTEPCONTROLINTERFACE_HEADER_INCLUDED
 
+#include <vector>
+
 
 namespace Opm
 {
@@ -58,6 +60,26 @@ namespace Opm
         /// \return suggested time step size for the next step
         virtual double computeTimeStepSize( const double dt, const int iterations, const RelativeChangeInterface& relativeChange , const double simulationTimeElapsed) const = 0;
 
+        /// record how the nonlinear solver converged during a step (default: ignored)
+        /// \param dt         time step size of the step
+        /// \param residuals  residual norm of each nonlinear iteration, scaled such that
+        ///                   values below one are converged
+        /// \param converged  whether the step converged
+        virtual void recordConvergenceHistory( const double /* dt */, const std::vector<double>& /* residuals */, const bool /* converged */ ) {}
+
+        /// limit the size of a step before it is attempted (default: unlimited)
+        /// \param dt  proposed time step size
+        ///
+        /// \return time step size which should be attempted
+        virtual double limitTimeStepSize( const double dt ) const { return dt; }
+
+        /// the internal state which the controller accumulated over the previous
+        /// steps, e.g. to write it to a checkpoint (default: none)
+        virtual std::vector<double> state() const { return std::vector<double>(); }
+
+        /// restore an internal state returned by state()
+        virtual void setState( const std::vector<double>& /* state */ ) {}
+
         /// virtual destructor (empty)
         virtual ~TimeStepControlInterface () {}
     };
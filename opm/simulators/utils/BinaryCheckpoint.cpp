@@ -0,0 +1,228 @@
+/*
+  Copyright 2019 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#include <opm/simulators/utils/BinaryCheckpoint.hpp>
+
+#include <opm/common/ErrorMacros.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Opm
+{
+
+namespace
+{
+    // all records start at multiples of 8 bytes, so the mapped data is
+    // suitably aligned for all element types
+    const std::size_t alignment = 8;
+    const char magic[alignment] = { 'O', 'P', 'M', 'C', 'H', 'K', 'P', '\0' };
+    const std::uint64_t formatVersion = 1;
+
+    std::size_t paddedSize(const std::size_t size)
+    {
+        return (size + alignment - 1)/alignment*alignment;
+    }
+} // anonymous namespace
+
+CheckpointWriter::CheckpointWriter(const std::string& fileName)
+    : fileName_(fileName)
+    , tmpFileName_(fileName + ".tmp")
+    , stream_(tmpFileName_, std::ios::binary | std::ios::trunc)
+    , committed_(false)
+{
+    if (!stream_) {
+        OPM_THROW(std::runtime_error, "Could not open checkpoint file " << tmpFileName_ << " for writing");
+    }
+
+    stream_.write(magic, alignment);
+    stream_.write(reinterpret_cast<const char*>(&formatVersion), sizeof(formatVersion));
+}
+
+CheckpointWriter::~CheckpointWriter()
+{
+    if (!committed_) {
+        stream_.close();
+        std::remove(tmpFileName_.c_str());
+    }
+}
+
+void CheckpointWriter::vector(const std::string& name, std::vector<bool>& v)
+{
+    std::vector<char> tmp(v.begin(), v.end());
+    vector(name, tmp);
+}
+
+void CheckpointWriter::commit()
+{
+    stream_.close();
+    if (!stream_) {
+        OPM_THROW(std::runtime_error, "Could not write checkpoint file " << tmpFileName_);
+    }
+    if (std::rename(tmpFileName_.c_str(), fileName_.c_str()) != 0) {
+        OPM_THROW(std::runtime_error, "Could not move checkpoint file " << tmpFileName_ << " to " << fileName_);
+    }
+    committed_ = true;
+}
+
+void CheckpointWriter::writeRecord_(const std::string& name, const void* data,
+                                    const std::size_t elementSize, const std::size_t count)
+{
+    const std::uint64_t header[] = { name.size(), elementSize, count };
+    stream_.write(reinterpret_cast<const char*>(&header[0]), sizeof(header[0]));
+    stream_.write(name.data(), name.size());
+    pad_(name.size());
+    stream_.write(reinterpret_cast<const char*>(&header[1]), 2*sizeof(header[0]));
+    if (count > 0) {
+        stream_.write(static_cast<const char*>(data), elementSize*count);
+    }
+    pad_(elementSize*count);
+}
+
+void CheckpointWriter::pad_(const std::size_t size)
+{
+    const char zeros[alignment] = {};
+    stream_.write(zeros, paddedSize(size) - size);
+}
+
+CheckpointReader::CheckpointReader(const std::string& fileName)
+    : fileName_(fileName)
+    , fd_(-1)
+    , mapping_(MAP_FAILED)
+    , size_(0)
+{
+    fd_ = ::open(fileName.c_str(), O_RDONLY);
+    struct stat fileStat;
+    if (fd_ < 0 || ::fstat(fd_, &fileStat) != 0) {
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+        OPM_THROW(std::runtime_error, "Could not open checkpoint file " << fileName);
+    }
+
+    size_ = fileStat.st_size;
+    if (size_ >= 2*alignment) {
+        mapping_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    }
+    if (mapping_ == MAP_FAILED
+        || std::memcmp(mapping_, magic, alignment) != 0)
+    {
+        release_();
+        OPM_THROW(std::runtime_error, "File " << fileName << " is not a checkpoint");
+    }
+
+    const char* begin = static_cast<const char*>(mapping_);
+    std::uint64_t version;
+    std::memcpy(&version, begin + alignment, sizeof(version));
+    if (version != formatVersion) {
+        release_();
+        OPM_THROW(std::runtime_error, "Checkpoint file " << fileName << " has the unsupported format version " << version);
+    }
+
+    // index the records
+    std::size_t pos = 2*alignment;
+    while (pos < size_) {
+        std::uint64_t nameSize;
+        std::uint64_t header[2];
+        bool valid = pos + sizeof(nameSize) <= size_;
+        if (valid) {
+            std::memcpy(&nameSize, begin + pos, sizeof(nameSize));
+            valid = nameSize <= size_ - pos - sizeof(nameSize);
+        }
+        const std::size_t namePos = pos + sizeof(nameSize);
+        const std::size_t headerPos = valid ? namePos + paddedSize(nameSize) : size_;
+        valid = valid && headerPos + sizeof(header) <= size_;
+        if (valid) {
+            std::memcpy(header, begin + headerPos, sizeof(header));
+            valid = header[0] > 0 && header[1] <= (size_ - headerPos - sizeof(header))/header[0];
+        }
+        if (!valid) {
+            release_();
+            OPM_THROW(std::runtime_error, "Checkpoint file " << fileName << " is truncated");
+        }
+
+        const std::size_t dataPos = headerPos + sizeof(header);
+        Record record = { begin + dataPos, header[0], header[1] };
+        records_[std::string(begin + namePos, nameSize)] = record;
+        pos = dataPos + paddedSize(header[0]*header[1]);
+    }
+}
+
+CheckpointReader::~CheckpointReader()
+{
+    release_();
+}
+
+void CheckpointReader::release_()
+{
+    if (mapping_ != MAP_FAILED) {
+        ::munmap(mapping_, size_);
+        mapping_ = MAP_FAILED;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+void CheckpointReader::vector(const std::string& name, std::vector<bool>& v)
+{
+    std::vector<char> tmp(v.size());
+    vector(name, tmp);
+    std::copy(tmp.begin(), tmp.end(), v.begin());
+}
+
+const CheckpointReader::Record&
+CheckpointReader::record_(const std::string& name, const std::size_t elementSize) const
+{
+    const auto it = records_.find(name);
+    if (it == records_.end()) {
+        OPM_THROW(std::runtime_error, "Checkpoint file " << fileName_ << " does not contain " << name);
+    }
+    if (it->second.elementSize != elementSize) {
+        OPM_THROW(std::runtime_error, "Record " << name << " of checkpoint file " << fileName_
+                  << " has elements of " << it->second.elementSize << " bytes, expected " << elementSize);
+    }
+    return it->second;
+}
+
+void CheckpointReader::readRecord_(const std::string& name, void* data,
+                                   const std::size_t elementSize, const std::size_t count) const
+{
+    const Record& record = record_(name, elementSize);
+    if (record.count != count) {
+        OPM_THROW(std::runtime_error, "Record " << name << " of checkpoint file " << fileName_
+                  << " has " << record.count << " entries, expected " << count);
+    }
+    if (count > 0) {
+        std::memcpy(data, record.data, elementSize*count);
+    }
+}
+
+} // namespace Opm
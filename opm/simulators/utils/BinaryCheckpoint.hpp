@@ -0,0 +1,173 @@
+/*
+  Copyright 2019 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_BINARYCHECKPOINT_HEADER_INCLUDED
+#define OPM_BINARYCHECKPOINT_HEADER_INCLUDED
+
+#include <cstddef>
+#include <fstream>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Opm
+{
+    /// Writes the state of a simulation to a binary checkpoint file.
+    ///
+    /// A checkpoint consists of named records, each of which holds an
+    /// array of trivially copyable values. The objects which are part of
+    /// the checkpoint implement a method
+    /// \code
+    ///     template <class Serializer>
+    ///     void checkpoint(Serializer& serializer);
+    /// \endcode
+    /// which passes their members to the serializer. This method is used
+    /// both with a CheckpointWriter and a CheckpointReader, so that the
+    /// order and the names of the records can not get out of sync.
+    ///
+    /// The records are written to a temporary file which replaces the
+    /// checkpoint file on commit(), i.e., an interrupted write never
+    /// destroys a previous checkpoint.
+    class CheckpointWriter
+    {
+    public:
+        explicit CheckpointWriter(const std::string& fileName);
+        ~CheckpointWriter();
+
+        CheckpointWriter(const CheckpointWriter&) = delete;
+        CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+        bool isReading() const
+        { return false; }
+
+        /// Write a single value.
+        template <class T>
+        void value(const std::string& name, T& v)
+        { array(name, &v, 1); }
+
+        /// Write a vector whose size is known when it is read.
+        template <class T>
+        void vector(const std::string& name, std::vector<T>& v)
+        { array(name, v.data(), v.size()); }
+
+        void vector(const std::string& name, std::vector<bool>& v);
+
+        /// Write a vector whose size is only known from the checkpoint.
+        template <class T>
+        void dynamicVector(const std::string& name, std::vector<T>& v)
+        { vector(name, v); }
+
+        /// Write an array of values.
+        template <class T>
+        void array(const std::string& name, const T* data, const std::size_t count)
+        {
+            static_assert(std::is_trivially_copyable<T>::value,
+                          "Only trivially copyable types can be written to checkpoints");
+            writeRecord_(name, data, sizeof(T), count);
+        }
+
+        /// Finish the checkpoint and move it to its final location.
+        void commit();
+
+    private:
+        void writeRecord_(const std::string& name, const void* data,
+                          std::size_t elementSize, std::size_t count);
+        void pad_(std::size_t size);
+
+        std::string fileName_;
+        std::string tmpFileName_;
+        std::ofstream stream_;
+        bool committed_;
+    };
+
+    /// Reads a checkpoint written by a CheckpointWriter.
+    ///
+    /// The file is memory mapped, so reading a record amounts to copying
+    /// it from the page cache into its destination.
+    class CheckpointReader
+    {
+    public:
+        explicit CheckpointReader(const std::string& fileName);
+        ~CheckpointReader();
+
+        CheckpointReader(const CheckpointReader&) = delete;
+        CheckpointReader& operator=(const CheckpointReader&) = delete;
+
+        bool isReading() const
+        { return true; }
+
+        /// Whether the checkpoint contains a record with the given name.
+        bool hasRecord(const std::string& name) const
+        { return records_.count(name) > 0; }
+
+        /// Read a single value.
+        template <class T>
+        void value(const std::string& name, T& v)
+        { array(name, &v, 1); }
+
+        /// Read a vector, which must already have the size it had when
+        /// it was written.
+        template <class T>
+        void vector(const std::string& name, std::vector<T>& v)
+        { array(name, v.data(), v.size()); }
+
+        void vector(const std::string& name, std::vector<bool>& v);
+
+        /// Read a vector and resize it to the number of stored values.
+        template <class T>
+        void dynamicVector(const std::string& name, std::vector<T>& v)
+        {
+            v.resize(record_(name, sizeof(T)).count);
+            vector(name, v);
+        }
+
+        /// Read an array of values. The number of values must match the
+        /// stored one.
+        template <class T>
+        void array(const std::string& name, T* data, const std::size_t count)
+        {
+            static_assert(std::is_trivially_copyable<T>::value,
+                          "Only trivially copyable types can be read from checkpoints");
+            readRecord_(name, data, sizeof(T), count);
+        }
+
+    private:
+        struct Record
+        {
+            const char* data;
+            std::size_t elementSize;
+            std::size_t count;
+        };
+
+        const Record& record_(const std::string& name, std::size_t elementSize) const;
+        void readRecord_(const std::string& name, void* data,
+                         std::size_t elementSize, std::size_t count) const;
+        void release_();
+
+        std::string fileName_;
+        int fd_;
+        void* mapping_;
+        std::size_t size_;
+        std::map<std::string, Record> records_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_BINARYCHECKPOINT_HEADER_INCLUDED
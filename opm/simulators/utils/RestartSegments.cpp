@@ -0,0 +1,171 @@
+/*
+  Copyright 2019 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#include <opm/simulators/utils/RestartSegments.hpp>
+#include <opm/simulators/utils/BinaryCheckpoint.hpp>
+
+#include <opm/output/data/Cells.hpp>
+#include <opm/parser/eclipse/Units/UnitSystem.hpp>
+#include <opm/common/ErrorMacros.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace Opm
+{
+
+std::string restartSegmentFileName(const std::string& outputDir,
+                                   const std::string& baseName,
+                                   int reportStep,
+                                   int segment)
+{
+    std::ostringstream fileName;
+    fileName << outputDir << "/" << baseName
+             << ".RSEG" << std::setw(4) << std::setfill('0') << reportStep
+             << "." << segment;
+    return fileName.str();
+}
+
+void writeRestartSegment(const std::string& fileName,
+                         int reportStep,
+                         int segment,
+                         int numSegments,
+                         int numGlobalCells,
+                         const std::vector<int>& globalIndex,
+                         const data::Solution& cellData)
+{
+    // the names of the keywords are stored as a sequence of null terminated strings
+    std::vector<char> keywords;
+    std::vector<int> measures;
+    std::vector<int> targets;
+    for (const auto& entry : cellData) {
+        if (entry.second.data.size() != globalIndex.size()) {
+            OPM_THROW(std::logic_error, "Restart data " << entry.first << " has " << entry.second.data.size()
+                      << " values, but the segment has " << globalIndex.size() << " cells");
+        }
+        keywords.insert(keywords.end(), entry.first.begin(), entry.first.end());
+        keywords.push_back('\0');
+        measures.push_back(static_cast<int>(entry.second.dim));
+        targets.push_back(static_cast<int>(entry.second.target));
+    }
+
+    CheckpointWriter writer(fileName);
+    writer.value("reportStep", reportStep);
+    writer.value("segment", segment);
+    writer.value("numSegments", numSegments);
+    writer.value("numCells", numGlobalCells);
+    writer.array("globalIndex", globalIndex.data(), globalIndex.size());
+    writer.vector("keywords", keywords);
+    writer.vector("measures", measures);
+    writer.vector("targets", targets);
+    for (const auto& entry : cellData) {
+        writer.array("data/" + entry.first, entry.second.data.data(), entry.second.data.size());
+    }
+    writer.commit();
+}
+
+data::Solution stitchRestartSegments(const std::string& outputDir,
+                                     const std::string& baseName,
+                                     int reportStep)
+{
+    data::Solution cellData;
+    int numSegments = 1;
+    int numGlobalCells = 0;
+    std::vector<char> cellWritten;
+    for (int segment = 0; segment < numSegments; ++segment) {
+        const std::string fileName = restartSegmentFileName(outputDir, baseName, reportStep, segment);
+        CheckpointReader reader(fileName);
+
+        int segmentReportStep = -1;
+        int segmentIdx = -1;
+        int segmentNumSegments = 0;
+        int segmentNumCells = 0;
+        reader.value("reportStep", segmentReportStep);
+        reader.value("segment", segmentIdx);
+        reader.value("numSegments", segmentNumSegments);
+        reader.value("numCells", segmentNumCells);
+        if (segment == 0) {
+            numSegments = segmentNumSegments;
+            numGlobalCells = segmentNumCells;
+            cellWritten.assign(numGlobalCells, 0);
+        }
+        if (segmentReportStep != reportStep || segmentIdx != segment
+            || segmentNumSegments != numSegments || segmentNumCells != numGlobalCells)
+        {
+            OPM_THROW(std::runtime_error, "Restart segment " << fileName << " does not belong to the same output as segment 0");
+        }
+
+        std::vector<int> globalIndex;
+        std::vector<char> keywords;
+        std::vector<int> measures;
+        std::vector<int> targets;
+        reader.dynamicVector("globalIndex", globalIndex);
+        reader.dynamicVector("keywords", keywords);
+        reader.dynamicVector("measures", measures);
+        reader.dynamicVector("targets", targets);
+        if (targets.size() != measures.size()) {
+            OPM_THROW(std::runtime_error, "Restart segment " << fileName << " is inconsistent");
+        }
+        for (const int globalIdx : globalIndex) {
+            if (globalIdx < 0 || globalIdx >= numGlobalCells) {
+                OPM_THROW(std::runtime_error, "Restart segment " << fileName << " contains the invalid cell index " << globalIdx);
+            }
+            if (cellWritten[globalIdx]) {
+                OPM_THROW(std::runtime_error, "Cell " << globalIdx << " of restart segment " << fileName
+                          << " is also part of another segment");
+            }
+            cellWritten[globalIdx] = 1;
+        }
+
+        std::vector<double> values(globalIndex.size());
+        auto keywordBegin = keywords.begin();
+        for (std::size_t keywordIdx = 0; keywordIdx < measures.size(); ++keywordIdx) {
+            const auto keywordEnd = std::find(keywordBegin, keywords.end(), '\0');
+            const std::string keyword(keywordBegin, keywordEnd);
+            keywordBegin = keywordEnd == keywords.end() ? keywordEnd : keywordEnd + 1;
+
+            if (!cellData.has(keyword)) {
+                cellData.insert(keyword,
+                                static_cast<UnitSystem::measure>(measures[keywordIdx]),
+                                std::vector<double>(numGlobalCells, 0.0),
+                                static_cast<data::TargetType>(targets[keywordIdx]));
+            }
+
+            reader.vector("data/" + keyword, values);
+            auto& globalValues = cellData.data(keyword);
+            for (std::size_t cellIdx = 0; cellIdx < globalIndex.size(); ++cellIdx) {
+                globalValues[globalIndex[cellIdx]] = values[cellIdx];
+            }
+        }
+    }
+
+    const auto missingCell = std::find(cellWritten.begin(), cellWritten.end(), 0);
+    if (missingCell != cellWritten.end()) {
+        OPM_THROW(std::runtime_error, "Cell " << (missingCell - cellWritten.begin())
+                  << " is not part of any restart segment of report step " << reportStep);
+    }
+
+    return cellData;
+}
+
+} // namespace Opm
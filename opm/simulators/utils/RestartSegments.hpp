@@ -0,0 +1,75 @@
+/*
+  Copyright 2019 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_RESTARTSEGMENTS_HEADER_INCLUDED
+#define OPM_RESTARTSEGMENTS_HEADER_INCLUDED
+
+#include <opm/output/data/Solution.hpp>
+
+#include <string>
+#include <vector>
+
+/// \file
+///
+/// Restart output of the cell data in segments, one per process.
+///
+/// With distributed output (--ecl-output-distributed=true), each process
+/// writes the cell data of its interior cells to its own segment file in
+/// the output directory, so the output directory must be on a file system
+/// which is shared by all processes. The simulator does not read the
+/// segments back. After the run, the cell data of a report step is
+/// assembled by stitchRestartSegments() and can then be written to an
+/// ECL restart file, e.g. by passing it to EclipseIO::writeTimeStep() as
+/// part of the RestartValue.
+
+namespace Opm
+{
+    /// Name of the file which holds the restart cell data of the given
+    /// segment, i.e., process, for a report step.
+    std::string restartSegmentFileName(const std::string& outputDir,
+                                       const std::string& baseName,
+                                       int reportStep,
+                                       int segment);
+
+    /// Write the restart cell data of one process to its segment file.
+    ///
+    /// The segment stores the global (active) index of each of its cells
+    /// along with the data, so the segments of all processes can be
+    /// stitched together without any further information. Every cell must
+    /// be part of exactly one segment, i.e., for a domain decomposition
+    /// only the interior cells of a process are written.
+    void writeRestartSegment(const std::string& fileName,
+                             int reportStep,
+                             int segment,
+                             int numSegments,
+                             int numGlobalCells,
+                             const std::vector<int>& globalIndex,
+                             const data::Solution& cellData);
+
+    /// Read all segments of a report step and assemble the cell data of
+    /// the whole grid, e.g. to write it to an ECL restart file. This is
+    /// meant to be run serially after the simulation. Throws
+    /// std::runtime_error if a cell is missing or part of several segments.
+    data::Solution stitchRestartSegments(const std::string& outputDir,
+                                         const std::string& baseName,
+                                         int reportStep);
+
+} // namespace Opm
+
+#endif // OPM_RESTARTSEGMENTS_HEADER_INCLUDED
@@ -0,0 +1,99 @@
+/*
+  Copyright 2019 Equinor.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+#include <opm/simulators/utils/allReduceSumMax.hpp>
+
+#if HAVE_MPI
+
+#include <algorithm>
+#include <cassert>
+#include <mpi.h>
+
+namespace
+{
+
+    // The reduced buffer is preceded by a header of two entries holding the
+    // number of summed entries and the total number of entries, so that the
+    // reduction operation knows which entries to add and which to compare.
+    const int header_size = 2;
+
+    void sumMaxOperation(void* in, void* inout, int* len, MPI_Datatype*)
+    {
+        const double* in_values = static_cast<const double*>(in);
+        double* inout_values = static_cast<double*>(inout);
+        for (int item = 0; item < *len; ++item) {
+            const int num_sum = static_cast<int>(in_values[0]);
+            const int num_values = static_cast<int>(in_values[1]);
+            for (int i = header_size; i < header_size + num_sum; ++i) {
+                inout_values[i] += in_values[i];
+            }
+            for (int i = header_size + num_sum; i < header_size + num_values; ++i) {
+                inout_values[i] = std::max(inout_values[i], in_values[i]);
+            }
+            in_values += header_size + num_values;
+            inout_values += header_size + num_values;
+        }
+    }
+
+} // anonymous namespace
+
+
+namespace Opm
+{
+
+    void allReduceSumMax(const Dune::CollectiveCommunication<Dune::MPIHelper::MPICommunicator>& comm,
+                         std::vector<double>& values, const int num_sum)
+    {
+        assert(num_sum >= 0 && num_sum <= static_cast<int>(values.size()));
+
+        const int num_values = values.size();
+        std::vector<double> buffer(header_size + num_values);
+        buffer[0] = num_sum;
+        buffer[1] = num_values;
+        std::copy(values.begin(), values.end(), buffer.begin() + header_size);
+
+        MPI_Datatype buffer_type;
+        MPI_Type_contiguous(buffer.size(), MPI_DOUBLE, &buffer_type);
+        MPI_Type_commit(&buffer_type);
+        MPI_Op sum_max;
+        MPI_Op_create(&sumMaxOperation, /*commute=*/1, &sum_max);
+
+        MPI_Allreduce(MPI_IN_PLACE, buffer.data(), 1, buffer_type, sum_max, comm);
+
+        MPI_Op_free(&sum_max);
+        MPI_Type_free(&buffer_type);
+
+        std::copy(buffer.begin() + header_size, buffer.end(), values.begin());
+    }
+
+} // namespace Opm
+
+#else // HAVE_MPI
+
+namespace Opm
+{
+    void allReduceSumMax(const Dune::CollectiveCommunication<Dune::MPIHelper::MPICommunicator>& /* comm */,
+                         std::vector<double>& /* values */, const int /* num_sum */)
+    {
+    }
+} // namespace Opm
+
+#endif // HAVE_MPI
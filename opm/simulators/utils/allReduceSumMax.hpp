@@ -0,0 +1,40 @@
+/*
+  Copyright 2019 Equinor.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_ALLREDUCESUMMAX_HEADER_INCLUDED
+#define OPM_ALLREDUCESUMMAX_HEADER_INCLUDED
+
+#include <dune/common/parallel/collectivecommunication.hh>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <vector>
+
+namespace Opm
+{
+
+    /// Reduce a buffer over all processes of a communicator in a single
+    /// collective operation. The first num_sum entries are replaced by their
+    /// sum over all processes, the remaining entries by their maximum.
+    void allReduceSumMax(const Dune::CollectiveCommunication<Dune::MPIHelper::MPICommunicator>& comm,
+                         std::vector<double>& values, const int num_sum);
+
+} // namespace Opm
+
+
+#endif // OPM_ALLREDUCESUMMAX_HEADER_INCLUDED
@@ -32,6 +32,7 @@
 
 #include <cassert>
 #include <tuple>
+#include <unordered_map>
 
 #include <opm/parser/eclipse/EclipseState/Schedule/Schedule.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/Well/WellTestState.hpp>
@@ -151,6 +152,20 @@ namespace Opm {
                 // TODO (?)
             }
 
+            /// Write the well state at the end of a report step to a binary
+            /// checkpoint or restore it from one, see CheckpointWriter. Before
+            /// the state is restored, the wells of that report step must have
+            /// been set up by beginReportStep().
+            template <class Serializer>
+            void checkpoint(Serializer& serializer)
+            {
+                well_state_.checkpoint(serializer);
+                if (serializer.isReading()) {
+                    previous_well_state_ = well_state_;
+                    initial_step_ = false;
+                }
+            }
+
             void beginEpisode()
             {
                 beginReportStep(ebosSimulator_.episodeIndex());
@@ -225,6 +240,16 @@ namespace Opm {
                 }
             }
 
+            // flag the cells which are perforated by any of the local wells
+            void markPerforatedCells(std::vector<bool>& perforated) const
+            {
+                for ( const auto& well: well_container_ ) {
+                    for (const int cell : well->cells()) {
+                        perforated[cell] = true;
+                    }
+                }
+            }
+
             // called at the beginning of a report step
             void beginReportStep(const int time_step);
 
@@ -279,12 +304,17 @@ namespace Opm {
             std::vector<bool> is_cell_perforated_;
 
             // create the well container
-            std::vector<WellInterfacePtr > createWellContainer(const int time_step, const Wells* wells, const bool allow_closing_opening_wells, Opm::DeferredLogger& deferred_logger);
+            // wells in reusable_wells whose definition did not change are taken over
+            // instead of being rebuilt
+            std::vector<WellInterfacePtr > createWellContainer(const int time_step, const Wells* wells, const bool allow_closing_opening_wells, Opm::DeferredLogger& deferred_logger,
+                                                               const std::vector<WellInterfacePtr>& reusable_wells = {});
 
             WellInterfacePtr createWellForWellTest(const std::string& well_name, const int report_step, Opm::DeferredLogger& deferred_logger) const;
 
             WellState well_state_;
             WellState previous_well_state_;
+            // the well state before solveWellEq(), used if the well equations fail to converge
+            WellState well_state_before_solve_;
 
             const ModelParameters param_;
             bool terminal_output_;
@@ -293,7 +293,10 @@ namespace Opm {
 
         Opm::DeferredLogger local_deferredLogger;
 
-        well_state_ = previous_well_state_;
+        // restart from the state at the end of the last successful time step. the
+        // wells only change at report steps, so the values are copied without
+        // reallocating the state.
+        well_state_.copyValuesFrom(previous_well_state_);
 
         const int reportStepIdx = ebosSimulator_.episodeIndex();
         const double simulationTime = ebosSimulator_.time();
@@ -303,10 +306,14 @@ namespace Opm {
             // test wells
             wellTesting(reportStepIdx, simulationTime, local_deferredLogger);
 
-            // create the well container
-            well_container_ = createWellContainer(reportStepIdx, wells(), /*allow_closing_opening_wells=*/true, local_deferredLogger);
+            // create the well container, wells whose definition did not change
+            // are taken over from the previous container with their allocated matrices
+            std::vector<WellInterfacePtr> previous_well_container;
+            previous_well_container.swap(well_container_);
+            well_container_ = createWellContainer(reportStepIdx, wells(), /*allow_closing_opening_wells=*/true, local_deferredLogger,
+                                                  previous_well_container);
 
-            // do the initialization for all the wells
+            // do the initialization for all the wells, including the ones taken over
             // TODO: to see whether we can postpone of the intialization of the well containers to
             // optimize the usage of the following several member variables
             for (auto& well : well_container_) {
@@ -419,7 +426,7 @@ namespace Opm {
             const std::string msg = "A zero well potential is returned for output purposes. ";
             local_deferredLogger.warning("WELL_POTENTIAL_CALCULATION_FAILED", msg);
         }
-        previous_well_state_ = well_state_;
+        previous_well_state_.copyValuesFrom(well_state_);
 
         Opm::DeferredLogger global_deferredLogger = gatherDeferredLogger(local_deferredLogger);
         if (terminal_output_) {
@@ -512,7 +519,8 @@ namespace Opm {
     template<typename TypeTag>
     std::vector<typename BlackoilWellModel<TypeTag>::WellInterfacePtr >
     BlackoilWellModel<TypeTag>::
-    createWellContainer(const int time_step, const Wells* wells, const bool allow_closing_opening_wells, Opm::DeferredLogger& deferred_logger)
+    createWellContainer(const int time_step, const Wells* wells, const bool allow_closing_opening_wells, Opm::DeferredLogger& deferred_logger,
+                        const std::vector<WellInterfacePtr>& reusable_wells)
     {
         std::vector<WellInterfacePtr> well_container;
 
@@ -521,6 +529,11 @@ namespace Opm {
         if (nw > 0) {
             well_container.reserve(nw);
 
+            std::unordered_map<std::string, WellInterfacePtr> reusable_well_map;
+            for (const auto& well : reusable_wells) {
+                reusable_well_map.emplace(well->name(), well);
+            }
+
             // With the following way, it will have the same order with wells struct
             // Hopefully, it can generate the same residual history with master branch
             for (int w = 0; w < nw; ++w) {
@@ -570,10 +583,8 @@ namespace Opm {
                             // TODO: make a function from well_state side to handle the following
                             well_state_.thp()[w] = 0.;
                             well_state_.bhp()[w] = 0.;
-                            const int np = numPhases();
-                            for (int p = 0; p < np; ++p) {
-                                well_state_.wellRates()[np * w + p] = 0.;
-                            }
+                            auto well_rates = well_state_.wellRates(w);
+                            std::fill(well_rates.begin(), well_rates.end(), 0.);
                             continue;
                         } else {
                             // close wells are added to the container but marked as closed
@@ -583,6 +594,14 @@ namespace Opm {
                     }
                 }
 
+                // take over the well from the previous container if only its controls changed
+                const auto reusable_well = reusable_well_map.find(well_name);
+                if (reusable_well != reusable_well_map.end()
+                    && reusable_well->second->updateWellDefinition(well_ecl, time_step, wells, *rateConverter_)) {
+                    well_container.push_back(reusable_well->second);
+                    continue;
+                }
+
                 // Use the pvtRegionIdx from the top cell
                 const int well_cell_top = wells->well_cells[wells->well_connpos[w]];
                 const int pvtreg = pvt_region_idx_[well_cell_top];
@@ -878,7 +897,8 @@ namespace Opm {
     BlackoilWellModel<TypeTag>::
     solveWellEq(const std::vector<Scalar>& B_avg, const double dt, Opm::DeferredLogger& deferred_logger)
     {
-        WellState well_state0 = well_state_;
+        // the well structure does not change here, so only the values are saved
+        well_state_before_solve_.copyValuesFrom(well_state_);
 
         const int max_iter = param_.max_welleq_iter_;
 
@@ -939,7 +959,7 @@ namespace Opm {
                     deferred_logger.debug("Well equation solution failed in getting converged with " + std::to_string(it) + " iterations");
                 }
 
-                well_state_ = well_state0;
+                well_state_.copyValuesFrom(well_state_before_solve_);
                 updatePrimaryVariables(deferred_logger);
                 // also recover the old well controls
                 for (const auto& well : well_container_) {
@@ -1367,8 +1387,8 @@ namespace Opm {
 
             // not sure necessary to change all the value to be positive
             if (is_producer) {
-                std::transform(well_state_.wellRates().begin() + np * w,
-                               well_state_.wellRates().begin() + np * (w + 1),
+                const auto rates = well_state_.wellRates(w);
+                std::transform(rates.begin(), rates.end(),
                                well_rates.begin(), std::negate<double>());
 
                 // the average hydrocarbon conditions of the whole field will be used
@@ -1380,9 +1400,8 @@ namespace Opm {
             } else {
                 // TODO: Not sure whether will encounter situation with all zero rates
                 // and whether it will cause problem here.
-                std::copy(well_state_.wellRates().begin() + np * w,
-                          well_state_.wellRates().begin() + np * (w + 1),
-                          well_rates.begin());
+                const auto rates = well_state_.wellRates(w);
+                std::copy(rates.begin(), rates.end(), well_rates.begin());
                 // the average hydrocarbon conditions of the whole field will be used
                 const int fipreg = 0; // Not considering FIP for the moment.
                 rateConverter_->calcCoeff(fipreg, pvtRegionIdx, convert_coeff);
@@ -1751,10 +1770,10 @@ namespace Opm {
             state.bhp()[ well_index ] = well.bhp;
             state.temperature()[ well_index ] = well.temperature;
             state.currentControls()[ well_index ] = well.control;
-            const auto wellrate_index = well_index * np;
+            auto well_rates = state.wellRates( well_index );
             for( size_t i = 0; i < phs.size(); ++i ) {
                 assert( well.rates.has( phs[ i ] ) );
-                state.wellRates()[ wellrate_index + i ] = well.rates.get( phs[ i ] );
+                well_rates[ i ] = well.rates.get( phs[ i ] );
             }
 
             const auto perforation_pressure = []( const data::Connection& comp ) {
@@ -1775,11 +1794,11 @@ namespace Opm {
                             state.perfRates().begin() + wm.second[ 1 ],
                     perforation_reservoir_rate );
 
+            auto perf_phase_rates = state.perfPhaseRates(well_index);
             int local_comp_index = 0;
             for (const data::Connection& comp : well.connections) {
-                const int global_comp_index = wm.second[1] + local_comp_index;
                 for (int phase_index = 0; phase_index < np; ++phase_index) {
-                    state.perfPhaseRates()[global_comp_index*np + phase_index] = comp.rates.get(phs[phase_index]);
+                    perf_phase_rates[local_comp_index*np + phase_index] = comp.rates.get(phs[phase_index]);
                 }
                 ++local_comp_index;
             }
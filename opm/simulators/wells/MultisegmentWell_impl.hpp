@@ -284,14 +284,15 @@ namespace Opm
 
             /* const Opm::PhaseUsage& pu = phaseUsage();
             std::vector<double> rates(3, 0.0);
+            const auto well_rates = well_state.wellRates(index_of_well_);
             if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
-                rates[ Water ] = well_state.wellRates()[index_of_well_ * number_of_phases_ + pu.phase_pos[ Water ] ];
+                rates[ Water ] = well_rates[ pu.phase_pos[ Water ] ];
             }
             if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
-                 rates[ Oil ] = well_state.wellRates()[index_of_well_ * number_of_phases_ + pu.phase_pos[ Oil ] ];
+                 rates[ Oil ] = well_rates[ pu.phase_pos[ Oil ] ];
             }
             if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
-                rates[ Gas ] = well_state.wellRates()[index_of_well_ * number_of_phases_ + pu.phase_pos[ Gas ] ];
+                rates[ Gas ] = well_rates[ pu.phase_pos[ Gas ] ];
             } */
 
             // const int table_id = well_controls_iget_vfp(well_controls_, current);
@@ -326,6 +327,7 @@ namespace Opm
 
             assert(numPhasesWithTargetsUnderThisControl > 0);
 
+            auto well_rates = well_state.wellRates(index_of_well_);
             if (well_type_ == INJECTOR) {
                 // assign target value as initial guess for injectors
                 // only handles single phase control at the moment
@@ -333,9 +335,9 @@ namespace Opm
 
                 for (int phase = 0; phase < number_of_phases_; ++phase) {
                     if (distr[phase] > 0.) {
-                        well_state.wellRates()[number_of_phases_ * index_of_well_ + phase] = target / distr[phase];
+                        well_rates[phase] = target / distr[phase];
                     } else {
-                        well_state.wellRates()[number_of_phases_ * index_of_well_ + phase] = 0.;
+                        well_rates[phase] = 0.;
                     }
                 }
 
@@ -348,7 +350,7 @@ namespace Opm
                 double original_rates_under_phase_control = 0.0;
                 for (int phase = 0; phase < number_of_phases_; ++phase) {
                     if (distr[phase] > 0.0) {
-                        original_rates_under_phase_control += well_state.wellRates()[number_of_phases_ * index_of_well_ + phase] * distr[phase];
+                        original_rates_under_phase_control += well_rates[phase] * distr[phase];
                     }
                 }
 
@@ -356,7 +358,7 @@ namespace Opm
                     double scaling_factor = target / original_rates_under_phase_control;
 
                     for (int phase = 0; phase < number_of_phases_; ++phase) {
-                        well_state.wellRates()[number_of_phases_ * index_of_well_ + phase] *= scaling_factor;
+                        well_rates[phase] *= scaling_factor;
 
                         // scaling the segment rates with the same way with well rates
                         const int top_segment_index = well_state.topSegmentIndex(index_of_well_);
@@ -369,10 +371,10 @@ namespace Opm
                     const double target_rate_divided = target / numPhasesWithTargetsUnderThisControl;
                     for (int phase = 0; phase < number_of_phases_; ++phase) {
                         if (distr[phase] > 0.0) {
-                            well_state.wellRates()[number_of_phases_ * index_of_well_ + phase] = target_rate_divided / distr[phase];
+                            well_rates[phase] = target_rate_divided / distr[phase];
                         } else {
                             // this only happens for SURFACE_RATE control
-                            well_state.wellRates()[number_of_phases_ * index_of_well_ + phase] = target_rate_divided;
+                            well_rates[phase] = target_rate_divided;
                         }
                     }
                     initSegmentRatesWithWellRates(well_state);
@@ -392,16 +394,16 @@ namespace Opm
     MultisegmentWell<TypeTag>::
     initSegmentRatesWithWellRates(WellState& well_state) const
     {
+        const auto well_rates = well_state.wellRates(index_of_well_);
+        auto perf_phase_rates = well_state.perfPhaseRates(index_of_well_);
         for (int phase = 0; phase < number_of_phases_; ++phase) {
-            const double perf_phaserate = well_state.wellRates()[number_of_phases_ * index_of_well_ + phase] / number_of_perforations_;
+            const double perf_phaserate = well_rates[phase] / number_of_perforations_;
             for (int perf = 0; perf < number_of_perforations_; ++perf) {
-                well_state.perfPhaseRates()[number_of_phases_ * (first_perf_ + perf) + phase] = perf_phaserate;
+                perf_phase_rates[number_of_phases_ * perf + phase] = perf_phaserate;
             }
         }
 
-        const std::vector<double> perforation_rates(well_state.perfPhaseRates().begin() + number_of_phases_ * first_perf_,
-                                                    well_state.perfPhaseRates().begin() +
-                                                    number_of_phases_ * (first_perf_ + number_of_perforations_) );
+        const std::vector<double> perforation_rates(perf_phase_rates.begin(), perf_phase_rates.end());
         std::vector<double> segment_rates;
         WellState::calculateSegmentRates(segment_inlets_, segment_perforations_, perforation_rates, number_of_phases_,
                                          0, segment_rates);
@@ -1829,7 +1831,7 @@ namespace Opm
                 const double phase_rate = g_total * fractions[p];
                 well_state.segRates()[(seg + top_segment_index) * number_of_phases_ + p] = phase_rate;
                 if (seg == 0) { // top segment
-                    well_state.wellRates()[index_of_well_ * number_of_phases_ + p] = phase_rate;
+                    well_state.wellRates(index_of_well_)[p] = phase_rate;
                 }
             }
 
@@ -2063,11 +2065,12 @@ namespace Opm
                 }
 
                 // store the perf pressure and rates
-                const int rate_start_offset = (first_perf_ + perf) * number_of_phases_;
+                const int rate_start_offset = perf * number_of_phases_;
+                auto perf_phase_rates = well_state.perfPhaseRates(index_of_well_);
                 for (int comp_idx = 0; comp_idx < num_components_; ++comp_idx) {
-                    well_state.perfPhaseRates()[rate_start_offset + ebosCompIdxToFlowCompIdx(comp_idx)] = cq_s[comp_idx].value();
+                    perf_phase_rates[rate_start_offset + ebosCompIdxToFlowCompIdx(comp_idx)] = cq_s[comp_idx].value();
                 }
-                well_state.perfPress()[first_perf_ + perf] = perf_press.value();
+                well_state.perfPress(index_of_well_)[perf] = perf_press.value();
 
                 for (int comp_idx = 0; comp_idx < num_components_; ++comp_idx) {
                     // the cq_s entering mass balance equations need to consider the efficiency factors.
@@ -33,6 +33,8 @@
 #include <dune/common/dynvector.hh>
 #include <dune/common/dynmatrix.hh>
 
+#include <array>
+
 namespace Opm
 {
 
@@ -239,6 +241,16 @@ namespace Opm
         // pressure drop between different perforations
         std::vector<double> perf_pressure_diffs_;
 
+        // work arrays for the computation of the connection densities and pressure
+        // differences, kept to avoid the reallocation for every update of the
+        // explicit quantities
+        std::vector<double> b_perf_;
+        std::vector<double> rsmax_perf_;
+        std::vector<double> rvmax_perf_;
+        std::vector<double> surf_dens_perf_;
+        std::vector<double> perf_component_rates_;
+        std::vector<double> q_out_perf_;
+
         // residuals of the well equations
         BVectorWell resWell_;
 
@@ -302,13 +314,12 @@ namespace Opm
 
         // TODO: not total sure whether it is a good idea to put this function here
         // the major reason to put here is to avoid the usage of Wells struct
-        void computeConnectionDensities(const std::vector<double>& perfComponentRates,
-                                        const std::vector<double>& b_perf,
-                                        const std::vector<double>& rsmax_perf,
-                                        const std::vector<double>& rvmax_perf,
-                                        const std::vector<double>& surf_dens_perf);
-
-        void computeConnectionPressureDelta();
+        // computes perf_densities_ and perf_pressure_diffs_ in a single pass over the perforations
+        void computeConnectionDensitiesAndPressureDelta(const std::vector<double>& perfComponentRates,
+                                                        const std::vector<double>& b_perf,
+                                                        const std::vector<double>& rsmax_perf,
+                                                        const std::vector<double>& rvmax_perf,
+                                                        const std::vector<double>& surf_dens_perf);
 
         void computeWellConnectionDensitesPressures(const WellState& well_state,
                                                     const std::vector<double>& b_perf,
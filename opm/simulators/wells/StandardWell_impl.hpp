@@ -66,6 +66,7 @@ namespace Opm
         }
 
         // counting/updating primary variable numbers
+        numWellEq_ = numStaticWellEq;
         if (this->has_polymermw && well_type_ == INJECTOR) {
             // adding a primary variable for water perforation rate per connection
             numWellEq_ += number_of_perforations_;
@@ -77,6 +78,13 @@ namespace Opm
         primary_variables_.resize(numWellEq_, 0.0);
         primary_variables_evaluation_.resize(numWellEq_, EvalWell{numWellEq_ + numEq, 0.0});
 
+        // a well which is taken over from the previous report step (see
+        // updateWellDefinition()) perforates the same cells, so its matrices
+        // already have the right sparsity pattern and block sizes
+        if (invDuneD_.N() > 0) {
+            return;
+        }
+
         // setup sparsity pattern for the matrices
         //[A C^T    [x    =  [ res
         // B D] x_well]      res_well]
@@ -509,9 +517,11 @@ namespace Opm
         well_state.wellDissolvedGasRates()[index_of_well_] = 0.;
 
         const int np = number_of_phases_;
-        for (int p = 0; p < np; ++p) {
-            well_state.productivityIndex()[np*index_of_well_ + p] = 0.;
-        }
+        auto well_productivity_index = well_state.productivityIndex(index_of_well_);
+        std::fill(well_productivity_index.begin(), well_productivity_index.end(), 0.);
+        auto perf_phase_rates = well_state.perfPhaseRates(index_of_well_);
+        auto perf_solvent_rates = well_state.perfRateSolvent(index_of_well_);
+        auto perf_press = well_state.perfPress(index_of_well_);
 
         for (int perf = 0; perf < number_of_perforations_; ++perf) {
 
@@ -565,9 +575,9 @@ namespace Opm
 
                 // Store the perforation phase flux for later usage.
                 if (has_solvent && componentIdx == contiSolventEqIdx) {
-                    well_state.perfRateSolvent()[first_perf_ + perf] = cq_s[componentIdx].value();
+                    perf_solvent_rates[perf] = cq_s[componentIdx].value();
                 } else {
-                    well_state.perfPhaseRates()[(first_perf_ + perf) * np + ebosCompIdxToFlowCompIdx(componentIdx)] = cq_s[componentIdx].value();
+                    perf_phase_rates[perf * np + ebosCompIdxToFlowCompIdx(componentIdx)] = cq_s[componentIdx].value();
                 }
             }
             if (has_energy) {
@@ -644,7 +654,7 @@ namespace Opm
             }
 
             // Store the perforation pressure for later usage.
-            well_state.perfPress()[first_perf_ + perf] = well_state.bhp()[index_of_well_] + perf_pressure_diffs_[perf];
+            perf_press[perf] = well_state.bhp()[index_of_well_] + perf_pressure_diffs_[perf];
 
             // Compute Productivity index if asked for
             const auto& pu = phaseUsage();
@@ -656,11 +666,11 @@ namespace Opm
                         || (pu.phase_pos[Gas] == p && summaryConfig.hasSummaryKey("WPIG:" + name()))) {
 
                     const unsigned int compIdx = flowPhaseToEbosCompIdx(p);
-                    const double drawdown = well_state.perfPress()[first_perf_ + perf] - intQuants.fluidState().pressure(FluidSystem::oilPhaseIdx).value();
+                    const double drawdown = perf_press[perf] - intQuants.fluidState().pressure(FluidSystem::oilPhaseIdx).value();
                     const bool new_well = schedule.hasWellEvent(name(), ScheduleEvents::NEW_WELL, current_step_);
                     double productivity_index = cq_s[compIdx].value() / drawdown;
                     scaleProductivityIndex(perf, productivity_index, new_well, deferred_logger);
-                    well_state.productivityIndex()[np*index_of_well_ + p] += productivity_index;
+                    well_productivity_index[p] += productivity_index;
                 }
             }
 
@@ -1107,17 +1117,18 @@ namespace Opm
 
         // calculate the phase rates based on the primary variables
         // for producers, this is not a problem, while not sure for injectors here
+        auto well_rates = well_state.wellRates(index_of_well_);
         if (well_type_ == PRODUCER) {
             const double g_total = primary_variables_[WQTotal];
             for (int p = 0; p < number_of_phases_; ++p) {
-                well_state.wellRates()[index_of_well_ * number_of_phases_ + p] = g_total * F[p];
+                well_rates[p] = g_total * F[p];
             }
         } else { // injectors
             // TODO: using comp_frac_ here is very dangerous, since we do not update it based on the injection phase
             // Either we use distr (might conflict with RESV related) or we update comp_frac_ based on the injection phase
             for (int p = 0; p < number_of_phases_; ++p) {
                 const double comp_frac = comp_frac_[p];
-                well_state.wellRates()[index_of_well_ * number_of_phases_ + p] = comp_frac * primary_variables_[WQTotal];
+                well_rates[p] = comp_frac * primary_variables_[WQTotal];
             }
         }
 
@@ -1125,9 +1136,11 @@ namespace Opm
 
         // other primary variables related to polymer injectivity study
         if (this->has_polymermw && well_type_ == INJECTOR) {
+            auto perf_water_velocity = well_state.perfWaterVelocity(index_of_well_);
+            auto perf_skin_pressure = well_state.perfSkinPressure(index_of_well_);
             for (int perf = 0; perf < number_of_perforations_; ++perf) {
-                well_state.perfWaterVelocity()[first_perf_ + perf] = primary_variables_[Bhp + 1 + perf];
-                well_state.perfSkinPressure()[first_perf_ + perf] = primary_variables_[Bhp + 1 + number_of_perforations_ + perf];
+                perf_water_velocity[perf] = primary_variables_[Bhp + 1 + perf];
+                perf_skin_pressure[perf] = primary_variables_[Bhp + 1 + number_of_perforations_ + perf];
             }
         }
     }
@@ -1157,14 +1170,15 @@ namespace Opm
             std::vector<double> rates(3, 0.0);
 
             const Opm::PhaseUsage& pu = phaseUsage();
+            const auto well_rates = well_state.wellRates(index_of_well_);
             if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
-                rates[ Water ] = well_state.wellRates()[index_of_well_ * number_of_phases_ + pu.phase_pos[ Water ] ];
+                rates[ Water ] = well_rates[ pu.phase_pos[ Water ] ];
             }
             if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
-                rates[ Oil ] = well_state.wellRates()[index_of_well_ * number_of_phases_ + pu.phase_pos[ Oil ] ];
+                rates[ Oil ] = well_rates[ pu.phase_pos[ Oil ] ];
             }
             if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
-                rates[ Gas ] = well_state.wellRates()[index_of_well_ * number_of_phases_ + pu.phase_pos[ Gas ] ];
+                rates[ Gas ] = well_rates[ pu.phase_pos[ Gas ] ];
             }
 
             const double bhp = well_state.bhp()[index_of_well_];
@@ -1232,6 +1246,7 @@ namespace Opm
 
             assert(numPhasesWithTargetsUnderThisControl > 0);
 
+            auto well_rates = well_state.wellRates(well_index);
             if (well_type_ == INJECTOR) {
                 // assign target value as initial guess for injectors
                 // only handles single phase control at the moment
@@ -1239,9 +1254,9 @@ namespace Opm
 
                 for (int phase = 0; phase < np; ++phase) {
                     if (distr[phase] > 0.) {
-                        well_state.wellRates()[np*well_index + phase] = target / distr[phase];
+                        well_rates[phase] = target / distr[phase];
                     } else {
-                        well_state.wellRates()[np * well_index + phase] = 0.;
+                        well_rates[phase] = 0.;
                     }
                 }
             } else if (well_type_ == PRODUCER) {
@@ -1251,7 +1266,7 @@ namespace Opm
                 double original_rates_under_phase_control = 0.0;
                 for (int phase = 0; phase < np; ++phase) {
                     if (distr[phase] > 0.0) {
-                        original_rates_under_phase_control += well_state.wellRates()[np * well_index + phase] * distr[phase];
+                        original_rates_under_phase_control += well_rates[phase] * distr[phase];
                     }
                 }
 
@@ -1259,17 +1274,17 @@ namespace Opm
                     const double scaling_factor = target / original_rates_under_phase_control;
 
                     for (int phase = 0; phase < np; ++phase) {
-                        well_state.wellRates()[np * well_index + phase] *= scaling_factor;
+                        well_rates[phase] *= scaling_factor;
                     }
                 } else { // scaling factor is not well defined when original_rates_under_phase_control is zero
                     // separating targets equally between phases under control
                     const double target_rate_divided = target / numPhasesWithTargetsUnderThisControl;
                     for (int phase = 0; phase < np; ++phase) {
                         if (distr[phase] > 0.0) {
-                            well_state.wellRates()[np * well_index + phase] = target_rate_divided / distr[phase];
+                            well_rates[phase] = target_rate_divided / distr[phase];
                         } else {
                             // this only happens for SURFACE_RATE control
-                            well_state.wellRates()[np * well_index + phase] = target_rate_divided;
+                            well_rates[phase] = target_rate_divided;
                         }
                     }
                 }
@@ -1659,9 +1674,7 @@ namespace Opm
         // TODO: double checke the obtained rates
         // this is another places we might obtain negative rates
 
-        for (int p = 0; p < number_of_phases_; ++p) {
-            well_state.wellRates()[number_of_phases_ * index_of_well_ + p] = rates[p];
-        }
+        std::copy(rates.begin(), rates.end(), well_state.wellRates(index_of_well_).begin());
 
         // TODO: there will be something need to be done for the cases not the defaulted 3 phases,
         // like 2 phases or solvent, polymer, etc. But we are not addressing them with THP control yet.
@@ -1732,6 +1745,12 @@ namespace Opm
             rvmax_perf.resize(nperf);
         }
 
+        // the well rates are the same for all the perforations
+        const auto well_rates = well_state.wellRates(w);
+        const double oilrate = oilPresent ? std::abs(well_rates[pu.phase_pos[Oil]]) : 0.0; //in order to handle negative rates in producers
+        const double gasrate = gasPresent ? std::abs(well_rates[pu.phase_pos[Gas]]) - well_state.solventWellRate(w) : 0.0;
+        const auto perf_press = well_state.perfPress(w);
+
         // Compute the average pressure in each well block
         for (int perf = 0; perf < nperf; ++perf) {
             const int cell_idx = well_cells_[perf];
@@ -1740,8 +1759,8 @@ namespace Opm
 
             // TODO: this is another place to show why WellState need to be a vector of WellState.
             // TODO: to check why should be perf - 1
-            const double p_above = perf == 0 ? well_state.bhp()[w] : well_state.perfPress()[first_perf_ + perf - 1];
-            const double p_avg = (well_state.perfPress()[first_perf_ + perf] + p_above)/2;
+            const double p_above = perf == 0 ? well_state.bhp()[w] : perf_press[perf - 1];
+            const double p_avg = (perf_press[perf] + p_above)/2;
             const double temperature = fs.temperature(FluidSystem::oilPhaseIdx).value();
 
             if (waterPresent) {
@@ -1753,14 +1772,10 @@ namespace Opm
             if (gasPresent) {
                 const unsigned gasCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
                 const int gaspos = gasCompIdx + perf * num_components_;
-                const int gaspos_well = pu.phase_pos[Gas] + w * pu.num_phases;
 
                 if (oilPresent) {
-                    const int oilpos_well = pu.phase_pos[Oil] + w * pu.num_phases;
-                    const double oilrate = std::abs(well_state.wellRates()[oilpos_well]); //in order to handle negative rates in producers
                     rvmax_perf[perf] = FluidSystem::gasPvt().saturatedOilVaporizationFactor(fs.pvtRegionIndex(), temperature, p_avg);
                     if (oilrate > 0) {
-                        const double gasrate = std::abs(well_state.wellRates()[gaspos_well]) - well_state.solventWellRate(w);
                         double rv = 0.0;
                         if (gasrate > 0) {
                             rv = oilrate / gasrate;
@@ -1781,13 +1796,9 @@ namespace Opm
             if (oilPresent) {
                 const unsigned oilCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
                 const int oilpos = oilCompIdx + perf * num_components_;
-                const int oilpos_well = pu.phase_pos[Oil] + w * pu.num_phases;
                 if (gasPresent) {
                     rsmax_perf[perf] = FluidSystem::oilPvt().saturatedGasDissolutionFactor(fs.pvtRegionIndex(), temperature, p_avg);
-                    const int gaspos_well = pu.phase_pos[Gas] + w * pu.num_phases;
-                    const double gasrate = std::abs(well_state.wellRates()[gaspos_well]) - well_state.solventWellRate(w);
                     if (gasrate > 0) {
-                        const double oilrate = std::abs(well_state.wellRates()[oilpos_well]);
                         double rs = 0.0;
                         if (oilrate > 0) {
                             rs = gasrate / oilrate;
@@ -1827,54 +1838,75 @@ namespace Opm
     template<typename TypeTag>
     void
     StandardWell<TypeTag>::
-    computeConnectionDensities(const std::vector<double>& perfComponentRates,
-                               const std::vector<double>& b_perf,
-                               const std::vector<double>& rsmax_perf,
-                               const std::vector<double>& rvmax_perf,
-                               const std::vector<double>& surf_dens_perf)
+    computeConnectionDensitiesAndPressureDelta(const std::vector<double>& perfComponentRates,
+                                               const std::vector<double>& b_perf,
+                                               const std::vector<double>& rsmax_perf,
+                                               const std::vector<double>& rvmax_perf,
+                                               const std::vector<double>& surf_dens_perf)
     {
         // Verify that we have consistent input.
         const int np = number_of_phases_;
         const int nperf = number_of_perforations_;
         const int num_comp = num_components_;
+        assert(num_comp == numWellConservationEq);
 
         // 1. Compute the flow (in surface volume units for each
         //    component) exiting up the wellbore from each perforation,
         //    taking into account flow from lower in the well, and
         //    in/out-flow at each perforation.
-        std::vector<double> q_out_perf(nperf*num_comp);
+        //    Iterate over well perforations from bottom to top.
+        q_out_perf_.resize(nperf * num_comp);
 
         // TODO: investigate whether we should use the following techniques to calcuate the composition of flows in the wellbore
-        // Iterate over well perforations from bottom to top.
         for (int perf = nperf - 1; perf >= 0; --perf) {
-            for (int component = 0; component < num_comp; ++component) {
-                if (perf == nperf - 1) {
-                    // This is the bottom perforation. No flow from below.
-                    q_out_perf[perf*num_comp+ component] = 0.0;
-                } else {
-                    // Set equal to flow from below.
-                    q_out_perf[perf*num_comp + component] = q_out_perf[(perf+1)*num_comp + component];
+            double* q_out = q_out_perf_.data() + perf * num_comp;
+            const double* q_perf = perfComponentRates.data() + perf * num_comp;
+            if (perf == nperf - 1) {
+                // This is the bottom perforation. No flow from below.
+                for (int component = 0; component < num_comp; ++component) {
+                    q_out[component] = 0.0 - q_perf[component];
+                }
+            } else {
+                // Flow from below minus the outflow through the perforation.
+                const double* q_below = q_out + num_comp;
+                for (int component = 0; component < num_comp; ++component) {
+                    q_out[component] = q_below[component] - q_perf[component];
                 }
-                // Subtract outflow through perforation.
-                q_out_perf[perf*num_comp + component] -= perfComponentRates[perf*num_comp + component];
             }
         }
 
-        // 2. Compute the component mix at each perforation as the
-        //    absolute values of the surface rates divided by their sum.
-        //    Then compute volume ratios (formation factors) for each perforation.
-        //    Finally compute densities for the segments associated with each perforation.
-        std::vector<double> mix(num_comp,0.0);
-        std::vector<double> x(num_comp);
-        std::vector<double> surf_dens(num_comp);
+        // 2. In a single pass from top to bottom, compute the component
+        //    mix at each perforation as the absolute values of the surface
+        //    rates divided by their sum, the volume ratios (formation factors)
+        //    and the density for the segment associated with each perforation.
+        //    The pressure difference between a perforation and the one above
+        //    it (or the reference depth for the first perforation) is then
+        //    accumulated to give the pressure difference to the bhp.
+        //    We'll assume the perforations are given in order from top to
+        //    bottom. By top and bottom we do not necessarily mean in a
+        //    geometric sense (depth), but in a topological sense: the 'top'
+        //    perforation is nearest to the surface topologically.
+        const bool oil_and_gas = FluidSystem::phaseIsActive(FluidSystem::gasCompIdx) && FluidSystem::phaseIsActive(FluidSystem::oilCompIdx);
+        const unsigned gaspos = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
+        const unsigned oilpos = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
+
+        perf_pressure_diffs_.resize(nperf, 0.0);
+        double pressure_diff = 0.0;
+        std::array<double, numWellConservationEq> mix;
+        mix.fill(0.0);
+        std::array<double, numWellConservationEq> x;
 
         for (int perf = 0; perf < nperf; ++perf) {
+            const double* q_out = q_out_perf_.data() + perf * num_comp;
+
             // Find component mix.
-            const double tot_surf_rate = std::accumulate(q_out_perf.begin() + num_comp*perf,
-                                                         q_out_perf.begin() + num_comp*(perf+1), 0.0);
+            double tot_surf_rate = 0.0;
+            for (int component = 0; component < num_comp; ++component) {
+                tot_surf_rate += q_out[component];
+            }
             if (tot_surf_rate != 0.0) {
                 for (int component = 0; component < num_comp; ++component) {
-                    mix[component] = std::fabs(q_out_perf[perf*num_comp + component]/tot_surf_rate);
+                    mix[component] = std::fabs(q_out[component]/tot_surf_rate);
                 }
             } else {
                 // No flow => use well specified fractions for mix.
@@ -1889,9 +1921,7 @@ namespace Opm
             x = mix;
 
             // Subtract dissolved gas from oil phase and vapporized oil from gas phase
-            if (FluidSystem::phaseIsActive(FluidSystem::gasCompIdx) && FluidSystem::phaseIsActive(FluidSystem::oilCompIdx)) {
-                const unsigned gaspos = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
-                const unsigned oilpos = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
+            if (oil_and_gas) {
                 double rs = 0.0;
                 double rv = 0.0;
                 if (!rsmax_perf.empty() && mix[oilpos] > 0.0) {
@@ -1906,60 +1936,28 @@ namespace Opm
                 }
                 if (rv != 0.0) {
                     // Subtract oil in gas from oil mixture
-                    x[oilpos] = (mix[oilpos] - mix[gaspos]*rv)/(1.0 - rs*rv);;
+                    x[oilpos] = (mix[oilpos] - mix[gaspos]*rv)/(1.0 - rs*rv);
                 }
             }
+
+            const double* b = b_perf.data() + perf * num_comp;
+            const double* surf_dens = surf_dens_perf.data() + perf * num_comp;
             double volrat = 0.0;
+            double mass = 0.0;
             for (int component = 0; component < num_comp; ++component) {
-                volrat += x[component] / b_perf[perf*num_comp+ component];
-            }
-            for (int component = 0; component < num_comp; ++component) {
-                surf_dens[component] = surf_dens_perf[perf*num_comp+ component];
+                volrat += x[component] / b[component];
+                mass += surf_dens[component] * mix[component];
             }
 
             // Compute segment density.
-            perf_densities_[perf] = std::inner_product(surf_dens.begin(), surf_dens.end(), mix.begin(), 0.0) / volrat;
-        }
-    }
-
-
-
-
-    template<typename TypeTag>
-    void
-    StandardWell<TypeTag>::
-    computeConnectionPressureDelta()
-    {
-        // Algorithm:
+            perf_densities_[perf] = mass / volrat;
 
-        // We'll assume the perforations are given in order from top to
-        // bottom for each well.  By top and bottom we do not necessarily
-        // mean in a geometric sense (depth), but in a topological sense:
-        // the 'top' perforation is nearest to the surface topologically.
-        // Our goal is to compute a pressure delta for each perforation.
-
-        // 1. Compute pressure differences between perforations.
-        //    dp_perf will contain the pressure difference between a
-        //    perforation and the one above it, except for the first
-        //    perforation for each well, for which it will be the
-        //    difference to the reference (bhp) depth.
-
-        const int nperf = number_of_perforations_;
-        perf_pressure_diffs_.resize(nperf, 0.0);
-
-        for (int perf = 0; perf < nperf; ++perf) {
+            // Compute the pressure difference to the reference point (bhp).
             const double z_above = perf == 0 ? ref_depth_ : perf_depth_[perf - 1];
             const double dz = perf_depth_[perf] - z_above;
-            perf_pressure_diffs_[perf] = dz * perf_densities_[perf] * gravity_;
+            pressure_diff += dz * perf_densities_[perf] * gravity_;
+            perf_pressure_diffs_[perf] = pressure_diff;
         }
-
-        // 2. Compute pressure differences to the reference point (bhp) by
-        //    accumulating the already computed adjacent pressure
-        //    differences, storing the result in dp_perf.
-        //    This accumulation must be done per well.
-        const auto beg = perf_pressure_diffs_.begin();
-        const auto end = perf_pressure_diffs_.end();
-        std::partial_sum(beg, end, beg);
     }
 
 
@@ -2037,21 +2035,20 @@ namespace Opm
         // Compute densities
         const int nperf = number_of_perforations_;
         const int np = number_of_phases_;
-        std::vector<double> perfRates(b_perf.size(),0.0);
+        perf_component_rates_.assign(b_perf.size(), 0.0);
 
+        const auto perf_phase_rates = well_state.perfPhaseRates(index_of_well_);
+        const auto perf_solvent_rates = well_state.perfRateSolvent(index_of_well_);
         for (int perf = 0; perf < nperf; ++perf) {
             for (int comp = 0; comp < np; ++comp) {
-                perfRates[perf * num_components_ + comp] =  well_state.perfPhaseRates()[(first_perf_ + perf) * np + ebosCompIdxToFlowCompIdx(comp)];
+                perf_component_rates_[perf * num_components_ + comp] = perf_phase_rates[perf * np + ebosCompIdxToFlowCompIdx(comp)];
             }
             if(has_solvent) {
-                perfRates[perf * num_components_ + contiSolventEqIdx] =  well_state.perfRateSolvent()[first_perf_ + perf];
+                perf_component_rates_[perf * num_components_ + contiSolventEqIdx] = perf_solvent_rates[perf];
             }
         }
 
-        computeConnectionDensities(perfRates, b_perf, rsmax_perf, rvmax_perf, surf_dens_perf);
-
-        computeConnectionPressureDelta();
-
+        computeConnectionDensitiesAndPressureDelta(perf_component_rates_, b_perf, rsmax_perf, rvmax_perf, surf_dens_perf);
     }
 
 
@@ -2064,15 +2061,11 @@ namespace Opm
     computeWellConnectionPressures(const Simulator& ebosSimulator,
                                    const WellState& well_state)
     {
-         // 1. Compute properties required by computeConnectionPressureDelta().
-         //    Note that some of the complexity of this part is due to the function
-         //    taking std::vector<double> arguments, and not Eigen objects.
-         std::vector<double> b_perf;
-         std::vector<double> rsmax_perf;
-         std::vector<double> rvmax_perf;
-         std::vector<double> surf_dens_perf;
-         computePropertiesForWellConnectionPressures(ebosSimulator, well_state, b_perf, rsmax_perf, rvmax_perf, surf_dens_perf);
-         computeWellConnectionDensitesPressures(well_state, b_perf, rsmax_perf, rvmax_perf, surf_dens_perf);
+         // 1. Compute properties required by computeConnectionDensitiesAndPressureDelta().
+         //    The per-perforation properties are stored in members of the well to
+         //    avoid reallocating them every time the explicit quantities are updated.
+         computePropertiesForWellConnectionPressures(ebosSimulator, well_state, b_perf_, rsmax_perf_, rvmax_perf_, surf_dens_perf_);
+         computeWellConnectionDensitesPressures(well_state, b_perf_, rsmax_perf_, rvmax_perf_, surf_dens_perf_);
     }
 
 
@@ -2442,7 +2435,7 @@ namespace Opm
                 for (int p = 0; p < np; ++p) {
                     // This is dangerous for new added well
                     // since we are not handling the initialization correctly for now
-                    well_potentials[p] = well_state.wellRates()[index_of_well_ * np + p];
+                    well_potentials[p] = well_state.wellRates(index_of_well_)[p];
                 }
             } else {
                 // We need to generate a reasonable rates to start the iteration process
@@ -2473,10 +2466,12 @@ namespace Opm
         const int well_index = index_of_well_;
         const int np = number_of_phases_;
 
+        const auto well_rates = well_state.wellRates(well_index);
+
         // the weighted total well rate
         double total_well_rate = 0.0;
         for (int p = 0; p < np; ++p) {
-            total_well_rate += scalingFactor(p) * well_state.wellRates()[np * well_index + p];
+            total_well_rate += scalingFactor(p) * well_rates[p];
         }
 
         // Not: for the moment, the first primary variable for the injectors is not G_total. The injection rate
@@ -2486,7 +2481,7 @@ namespace Opm
             for (int p = 0; p < np; ++p) {
                 // TODO: the use of comp_frac_ here is dangerous, since the injection phase can be different from
                 // prefered phasse in WELSPECS, while comp_frac_ only reflect the one specified in WELSPECS
-                primary_variables_[WQTotal] += well_state.wellRates()[np * well_index + p] * comp_frac_[p];
+                primary_variables_[WQTotal] += well_rates[p] * comp_frac_[p];
             }
         } else {
             for (int p = 0; p < np; ++p) {
@@ -2501,10 +2496,10 @@ namespace Opm
 
         if(std::abs(total_well_rate) > 0.) {
             if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
-                primary_variables_[WFrac] = scalingFactor(pu.phase_pos[Water]) * well_state.wellRates()[np*well_index + pu.phase_pos[Water]] / total_well_rate;
+                primary_variables_[WFrac] = scalingFactor(pu.phase_pos[Water]) * well_rates[pu.phase_pos[Water]] / total_well_rate;
             }
             if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
-                primary_variables_[GFrac] = scalingFactor(pu.phase_pos[Gas]) * (well_state.wellRates()[np*well_index + pu.phase_pos[Gas]] - well_state.solventWellRate(well_index)) / total_well_rate ;
+                primary_variables_[GFrac] = scalingFactor(pu.phase_pos[Gas]) * (well_rates[pu.phase_pos[Gas]] - well_state.solventWellRate(well_index)) / total_well_rate ;
             }
             if (has_solvent) {
                 primary_variables_[SFrac] = scalingFactor(pu.phase_pos[Gas]) * well_state.solventWellRate(well_index) / total_well_rate ;
@@ -2553,9 +2548,11 @@ namespace Opm
 
         // other primary variables related to polymer injection
         if (this->has_polymermw && well_type_ == INJECTOR) {
+            const auto perf_water_velocity = well_state.perfWaterVelocity(index_of_well_);
+            const auto perf_skin_pressure = well_state.perfSkinPressure(index_of_well_);
             for (int perf = 0; perf < number_of_perforations_; ++perf) {
-                primary_variables_[Bhp + 1 + perf] = well_state.perfWaterVelocity()[first_perf_ + perf];
-                primary_variables_[Bhp + 1 + number_of_perforations_ + perf] = well_state.perfSkinPressure()[first_perf_ + perf];
+                primary_variables_[Bhp + 1 + perf] = perf_water_velocity[perf];
+                primary_variables_[Bhp + 1 + number_of_perforations_ + perf] = perf_skin_pressure[perf];
             }
         }
     }
@@ -3033,11 +3030,12 @@ namespace Opm
     updateWaterThroughput(const double dt, WellState &well_state) const
     {
         if (this->has_polymermw && well_type_ == INJECTOR) {
+            auto perf_throughput = well_state.perfThroughput(index_of_well_);
             for (int perf = 0; perf < number_of_perforations_; ++perf) {
                 const double perf_water_vel = primary_variables_[Bhp + 1 + perf];
                 // we do not consider the formation damage due to water flowing from reservoir into wellbore
                 if (perf_water_vel > 0.) {
-                    well_state.perfThroughput()[first_perf_ + perf] += perf_water_vel * dt;
+                    perf_throughput[perf] += perf_water_vel * dt;
                 }
             }
         }
@@ -3069,7 +3067,7 @@ namespace Opm
         const EvalWell eq_wat_vel = primary_variables_evaluation_[wat_vel_index] - water_velocity;
         resWell_[0][wat_vel_index] = eq_wat_vel.value();
 
-        const double throughput = well_state.perfThroughput()[first_perf_ + perf];
+        const double throughput = well_state.perfThroughput(index_of_well_)[perf];
         const int pskin_index = Bhp + 1 + number_of_perforations_ + perf;
 
         EvalWell poly_conc(numWellEq_ + numEq, 0.0);
@@ -3206,7 +3204,7 @@ namespace Opm
             const int wat_vel_index = Bhp + 1 + perf;
             const EvalWell water_velocity = primary_variables_evaluation_[wat_vel_index];
             if (water_velocity > 0.) { // injecting
-                const double throughput = well_state.perfThroughput()[first_perf_ + perf];
+                const double throughput = well_state.perfThroughput(index_of_well_)[perf];
                 const EvalWell molecular_weight = wpolymermw(throughput, water_velocity, deferred_logger);
                 cq_s_polymw *= molecular_weight;
             } else {
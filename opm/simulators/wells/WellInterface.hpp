@@ -57,6 +57,7 @@
 #include <opm/material/densead/Math.hpp>
 #include <opm/material/densead/Evaluation.hpp>
 
+#include <algorithm>
 #include <string>
 #include <memory>
 #include <vector>
@@ -145,6 +146,15 @@ namespace Opm
                           const double gravity_arg,
                           const int num_cells);
 
+        /// Re-bind an already initialized well to the well definition, the
+        /// Wells struct and the rate converter of a new (report) step, keeping
+        /// its allocated matrices and perforation vectors. Returns false if the
+        /// structure of the well changed, in which case the well must be
+        /// rebuilt. Multisegment wells are always rebuilt. init() still needs
+        /// to be called for a re-bound well.
+        bool updateWellDefinition(const Well2& well, const int time_step, const Wells* wells,
+                                  const RateConverterType& rate_converter);
+
         virtual void initPrimaryVariablesEvaluation() const = 0;
 
         virtual ConvergenceReport getWellConvergence(const std::vector<double>& B_avg, Opm::DeferredLogger& deferred_logger) const = 0;
@@ -263,9 +273,9 @@ namespace Opm
         // to indicate a invalid completion
         static const int INVALIDCOMPLETION = INT_MAX;
 
-        const Well2 well_ecl_;
+        Well2 well_ecl_;
 
-        const int current_step_;
+        int current_step_;
 
         // the index of well in Wells struct
         int index_of_well_;
@@ -345,8 +355,9 @@ namespace Opm
 
         double gravity_;
 
-        // For the conversion between the surface volume rate and resrevoir voidage rate
-        const RateConverterType& rateConverter_;
+        // For the conversion between the surface volume rate and resrevoir voidage rate.
+        // The converter is recreated at every report step, see updateWellDefinition().
+        const RateConverterType* rateConverter_;
 
         // The pvt region of the well. We assume
         // We assume a well to not penetrate more than one pvt region.
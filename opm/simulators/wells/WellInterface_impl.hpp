@@ -35,7 +35,7 @@ namespace Opm
       : well_ecl_(well)
       , current_step_(time_step)
       , param_(param)
-      , rateConverter_(rate_converter)
+      , rateConverter_(&rate_converter)
       , pvtRegionIdx_(pvtRegionIdx)
       , num_components_(num_components)
     {
@@ -140,6 +140,76 @@ namespace Opm
 
 
 
+    template<typename TypeTag>
+    bool
+    WellInterface<TypeTag>::
+    updateWellDefinition(const Well2& well, const int time_step, const Wells* wells,
+                         const RateConverterType& rate_converter)
+    {
+        assert(wells);
+        assert(well.name() == name());
+
+        // the segment structure of multisegment wells is set up in the constructor
+        if (well.isMultiSegment() || well_ecl_.isMultiSegment()) {
+            return false;
+        }
+
+        // looking for the location of the well in the new wells struct
+        int index_well;
+        for (index_well = 0; index_well < wells->number_of_wells; ++index_well) {
+            if (name() == std::string(wells->name[index_well])) {
+                break;
+            }
+        }
+
+        if (index_well == wells->number_of_wells) {
+            return false;
+        }
+
+        // the allocated linear system depends on the well type and the perforated cells
+        const int perf_index_begin = wells->well_connpos[index_well];
+        const int perf_index_end = wells->well_connpos[index_well + 1];
+        if (wells->type[index_well] != well_type_
+            || wells->number_of_phases != number_of_phases_
+            || perf_index_end - perf_index_begin != number_of_perforations_
+            || !std::equal(well_cells_.begin(), well_cells_.end(), wells->well_cells + perf_index_begin)) {
+            return false;
+        }
+
+        well_ecl_ = well;
+        current_step_ = time_step;
+        rateConverter_ = &rate_converter;
+        index_of_well_ = index_well;
+
+        const int index_begin = index_well * number_of_phases_;
+        std::copy(wells->comp_frac + index_begin,
+                  wells->comp_frac + index_begin + number_of_phases_, comp_frac_.begin() );
+
+        well_controls_ = wells->ctrls[index_well];
+        ref_depth_ = wells->depth_ref[index_well];
+        first_perf_ = perf_index_begin;
+
+        // the well indices are reset since closed completions might have been re-opened
+        std::copy(wells->WI + perf_index_begin,
+                  wells->WI + perf_index_end,
+                  well_index_.begin() );
+        std::copy(wells->sat_table_id + perf_index_begin,
+                  wells->sat_table_id + perf_index_end,
+                  saturation_table_number_.begin() );
+
+        completions_.clear();
+        initCompletions();
+
+        well_efficiency_factor_ = 1.0;
+        operability_status_.reset();
+
+        return true;
+    }
+
+
+
+
+
     template<typename TypeTag>
     void
     WellInterface<TypeTag>::
@@ -560,11 +630,11 @@ namespace Opm
                         Opm::DeferredLogger& deferred_logger) const
     {
         const Opm::PhaseUsage& pu = phaseUsage();
-        const int np = number_of_phases_;
+        const auto well_rates = well_state.wellRates(index_of_well_);
 
         if (econ_production_limits.onMinOilRate()) {
             assert(FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx));
-            const double oil_rate = well_state.wellRates()[index_of_well_ * np + pu.phase_pos[ Oil ] ];
+            const double oil_rate = well_rates[pu.phase_pos[ Oil ]];
             const double min_oil_rate = econ_production_limits.minOilRate();
             if (std::abs(oil_rate) < min_oil_rate) {
                 return true;
@@ -573,7 +643,7 @@ namespace Opm
 
         if (econ_production_limits.onMinGasRate() ) {
             assert(FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx));
-            const double gas_rate = well_state.wellRates()[index_of_well_ * np + pu.phase_pos[ Gas ] ];
+            const double gas_rate = well_rates[pu.phase_pos[ Gas ]];
             const double min_gas_rate = econ_production_limits.minGasRate();
             if (std::abs(gas_rate) < min_gas_rate) {
                 return true;
@@ -583,8 +653,8 @@ namespace Opm
         if (econ_production_limits.onMinLiquidRate() ) {
             assert(FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx));
             assert(FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx));
-            const double oil_rate = well_state.wellRates()[index_of_well_ * np + pu.phase_pos[ Oil ] ];
-            const double water_rate = well_state.wellRates()[index_of_well_ * np + pu.phase_pos[ Water ] ];
+            const double oil_rate = well_rates[pu.phase_pos[ Oil ]];
+            const double water_rate = well_rates[pu.phase_pos[ Water ]];
             const double liquid_rate = oil_rate + water_rate;
             const double min_liquid_rate = econ_production_limits.minLiquidRate();
             if (std::abs(liquid_rate) < min_liquid_rate) {
@@ -715,13 +785,8 @@ namespace Opm
                            const double max_ratio_limit,
                            const RatioFunc& ratioFunc) const
     {
-        const int np = number_of_phases_;
-
-        std::vector<double> well_rates(np, 0.0);
-
-        for (int p = 0; p < np; ++p) {
-            well_rates[p] = well_state.wellRates()[index_of_well_ * np + p];
-        }
+        const auto rates = well_state.wellRates(index_of_well_);
+        const std::vector<double> well_rates(rates.begin(), rates.end());
 
         const double well_ratio = ratioFunc(well_rates, phaseUsage());
 
@@ -748,6 +813,8 @@ namespace Opm
         // it is used to identify the most offending completion
         double max_ratio_completion = 0;
 
+        const auto perf_phase_rates = well_state.perfPhaseRates(index_of_well_);
+
         // look for the worst_offending_completion
         for (const auto& completion : completions_) {
 
@@ -757,10 +824,8 @@ namespace Opm
             // looping through the connections associated with the completion
             const std::vector<int>& conns = completion.second;
             for (const int c : conns) {
-                const int index_con = c + first_perf_;
-
                 for (int p = 0; p < np; ++p) {
-                    const double connection_rate = well_state.perfPhaseRates()[index_con * np + p];
+                    const double connection_rate = perf_phase_rates[c * np + p];
                     completion_rates[p] += connection_rate;
                 }
             } // end of for (const int c : conns)
@@ -1148,7 +1213,7 @@ namespace Opm
             if (has_solvent && phaseIdx == contiSolventEqIdx ) {
                 typedef Ewoms::BlackOilSolventModule<TypeTag> SolventModule;
                 double coeff = 0;
-                rateConverter_.template calcCoeffSolvent<SolventModule>(0, pvtRegionIdx_, coeff);
+                rateConverter_->template calcCoeffSolvent<SolventModule>(0, pvtRegionIdx_, coeff);
                 return coeff;
             }
             // TODO: use the rateConverter here as well.
@@ -1257,18 +1322,14 @@ namespace Opm
         const int fipreg = 0; // not considering the region for now
         const int np = number_of_phases_;
 
-        std::vector<double> surface_rates(np, 0.0);
-        const int well_rate_index = np * index_of_well_;
-        for (int p = 0; p < np; ++p) {
-            surface_rates[p] = well_state.wellRates()[well_rate_index + p];
-        }
+        const auto rates = well_state.wellRates(index_of_well_);
+        const std::vector<double> surface_rates(rates.begin(), rates.end());
 
         std::vector<double> voidage_rates(np, 0.0);
-        rateConverter_.calcReservoirVoidageRates(fipreg, pvtRegionIdx_, surface_rates, voidage_rates);
+        rateConverter_->calcReservoirVoidageRates(fipreg, pvtRegionIdx_, surface_rates, voidage_rates);
 
-        for (int p = 0; p < np; ++p) {
-            well_state.wellReservoirRates()[well_rate_index + p] = voidage_rates[p];
-        }
+        auto reservoir_rates = well_state.wellReservoirRates(index_of_well_);
+        std::copy(voidage_rates.begin(), voidage_rates.end(), reservoir_rates.begin());
     }
 
     template<typename TypeTag>
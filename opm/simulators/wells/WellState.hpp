@@ -298,6 +298,46 @@ namespace Opm
             return *this;
         }
 
+        /// Copy the values of another state of the same set of wells. In
+        /// contrast to the assignment operator, the well structure and the
+        /// name mapping are kept, so no memory is allocated.
+        void copyValuesFrom(const WellState& rhs)
+        {
+            if (!hasSameWells(rhs)) {
+                *this = rhs;
+                return;
+            }
+
+            this->bhp_ = rhs.bhp_;
+            this->thp_ = rhs.thp_;
+            this->temperature_ = rhs.temperature_;
+            this->wellrates_ = rhs.wellrates_;
+            this->perfrates_ = rhs.perfrates_;
+            this->perfpress_ = rhs.perfpress_;
+        }
+
+        /// Write the values of the state to a checkpoint or read them from
+        /// it, see CheckpointWriter. When reading, the state must already
+        /// have been set up for the wells which were active when the
+        /// checkpoint was written.
+        template <class Serializer>
+        void checkpoint(Serializer& serializer)
+        {
+            serializer.vector("wells/bhp", bhp_);
+            serializer.vector("wells/thp", thp_);
+            serializer.vector("wells/temperature", temperature_);
+            serializer.vector("wells/wellrates", wellrates_);
+            serializer.vector("wells/perfrates", perfrates_);
+            serializer.vector("wells/perfpress", perfpress_);
+        }
+
+        /// Whether both states describe the same wells and connections.
+        bool hasSameWells(const WellState& rhs) const
+        {
+            return (this->wells_ == nullptr) == (rhs.wells_ == nullptr)
+                && this->wellMap_ == rhs.wellMap_;
+        }
+
     private:
         std::vector<double> bhp_;
         std::vector<double> thp_;
@@ -38,6 +38,8 @@
 #include <map>
 #include <algorithm>
 #include <array>
+#include <numeric>
+#include <type_traits>
 
 namespace Opm
 {
@@ -63,6 +65,46 @@ namespace Opm
         using BaseType :: numWells;
         using BaseType :: numPhases;
 
+        /// Non-owning view of the contiguous record of a single well
+        /// inside one of the flat per-well or per-perforation arrays.
+        /// The arrays are ordered by well, so the record of well w is
+        /// always one consecutive range and the views replace the
+        /// explicit index arithmetic (w * np + p) in the well models.
+        /// The arrays themselves remain separate vectors; a view is
+        /// created from the connection offsets of the wells on every
+        /// access, which only costs two index lookups.
+        template <class Scalar>
+        class WellRecord
+        {
+        public:
+            WellRecord(Scalar* data, const int size)
+                : data_(data)
+                , size_(size)
+            {}
+
+            Scalar& operator[](const int i)
+            {
+                assert(i >= 0 && i < size_);
+                return data_[i];
+            }
+
+            const Scalar& operator[](const int i) const
+            {
+                assert(i >= 0 && i < size_);
+                return data_[i];
+            }
+
+            Scalar* begin() { return data_; }
+            Scalar* end() { return data_ + size_; }
+            const Scalar* begin() const { return data_; }
+            const Scalar* end() const { return data_ + size_; }
+            int size() const { return size_; }
+
+        private:
+            Scalar* data_;
+            int size_;
+        };
+
         /// Allocate and initialize if wells is non-null.  Also tries
         /// to give useful initial values to the bhp(), wellRates()
         /// and perfPhaseRates() fields, depending on controls
@@ -127,16 +169,12 @@ namespace Opm
             } // end of if (!well_ecl.empty() )
 
             // Ensure that we start out with zero rates by default.
-            perfphaserates_.clear();
-            perfphaserates_.resize(nperf * np, 0.0);
+            perfphaserates_.assign(nperf * np, 0.0);
 
             // these are only used to monitor the injectivity
-            perf_water_throughput_.clear();
-            perf_water_throughput_.resize(nperf, 0.0);
-            perf_water_velocity_.clear();
-            perf_water_velocity_.resize(nperf, 0.0);
-            perf_skin_pressure_.clear();
-            perf_skin_pressure_.resize(nperf, 0.0);
+            perf_water_throughput_.assign(nperf, 0.0);
+            perf_water_velocity_.assign(nperf, 0.0);
+            perf_skin_pressure_.assign(nperf, 0.0);
 
             for (int w = 0; w < nw; ++w) {
                 assert((wells->type[w] == INJECTOR) || (wells->type[w] == PRODUCER));
@@ -148,11 +186,14 @@ namespace Opm
                     const int num_perf_this_well = wells->well_connpos[w + 1] - wells->well_connpos[w];
                     // Open well: Initialize perfphaserates_ to well
                     // rates divided by the number of perforations.
-                    for (int perf = wells->well_connpos[w]; perf < wells->well_connpos[w + 1]; ++perf) {
+                    const auto rates = wellRates(w);
+                    auto perf_rates = perfPhaseRates(w);
+                    for (int perf = 0; perf < num_perf_this_well; ++perf) {
                         for (int p = 0; p < np; ++p) {
-                            perfphaserates_[np*perf + p] = wellRates()[np*w + p] / double(num_perf_this_well);
+                            perf_rates[np*perf + p] = rates[p] / double(num_perf_this_well);
                         }
-                        perfPress()[perf] = cellPressures[wells->well_cells[perf]];
+                        const int perf_idx = wells->well_connpos[w] + perf;
+                        perfPress()[perf_idx] = cellPressures[wells->well_cells[perf_idx]];
                     }
                 }
             }
@@ -162,8 +203,7 @@ namespace Opm
             for (int w = 0; w < nw; ++w) {
                 current_controls_[w] = well_controls_get_current(wells->ctrls[w]);
             }
-            perfRateSolvent_.clear();
-            perfRateSolvent_.resize(nperf, 0.0);
+            perfRateSolvent_.assign(nperf, 0.0);
             productivity_index_.resize(nw * np, 0.0);
             well_potentials_.resize(nw * np, 0.0);
 
@@ -195,10 +235,9 @@ namespace Opm
                         }
 
                         // wellrates
-                        for( int i=0, idx=newIndex*np, oldidx=oldIndex*np; i<np; ++i, ++idx, ++oldidx )
-                        {
-                            wellRates()[ idx ] = prevState->wellRates()[ oldidx ];
-                        }
+                        const auto old_rates = prevState->wellRates(oldIndex);
+                        const auto new_rates = wellRates(newIndex);
+                        std::copy(old_rates.begin(), old_rates.end(), new_rates.begin());
 
                         // perfPhaseRates
                         const int oldPerf_idx_beg = (*it).second[ 1 ];
@@ -206,18 +245,15 @@ namespace Opm
                         const int num_perf_this_well = wells->well_connpos[newIndex + 1] - wells->well_connpos[newIndex];
                         // copy perforation rates when the number of perforations is equal,
                         // otherwise initialize perfphaserates to well rates divided by the number of perforations.
+                        auto perf_rates = perfPhaseRates(newIndex);
                         if( num_perf_old_well == num_perf_this_well )
                         {
-                            int old_perf_phase_idx = oldPerf_idx_beg *np;
-                            for (int perf_phase_idx = wells->well_connpos[ newIndex ]*np;
-                                 perf_phase_idx < wells->well_connpos[ newIndex + 1]*np; ++perf_phase_idx, ++old_perf_phase_idx )
-                            {
-                                perfPhaseRates()[ perf_phase_idx ] = prevState->perfPhaseRates()[ old_perf_phase_idx ];
-                            }
+                            const auto old_perf_rates = prevState->perfPhaseRates(oldIndex);
+                            std::copy(old_perf_rates.begin(), old_perf_rates.end(), perf_rates.begin());
                         } else {
-                            for (int perf = wells->well_connpos[newIndex]; perf < wells->well_connpos[newIndex + 1]; ++perf) {
+                            for (int perf = 0; perf < num_perf_this_well; ++perf) {
                                 for (int p = 0; p < np; ++p) {
-                                    perfPhaseRates()[np*perf + p] = wellRates()[np*newIndex + p] / double(num_perf_this_well);
+                                    perf_rates[np*perf + p] = new_rates[p] / double(num_perf_this_well);
                                 }
                             }
                         }
@@ -351,11 +387,14 @@ namespace Opm
                     const int num_perf_this_well = wells->well_connpos[w + 1] - wells->well_connpos[w];
                     // Open well: Initialize perfphaserates_ to well
                     // rates divided by the number of perforations.
-                    for (int perf = wells->well_connpos[w]; perf < wells->well_connpos[w + 1]; ++perf) {
+                    const auto rates = wellRates(w);
+                    auto perf_rates = perfPhaseRates(w);
+                    for (int perf = 0; perf < num_perf_this_well; ++perf) {
                         for (int p = 0; p < np; ++p) {
-                            perfphaserates_[np*perf + p] = wellRates()[np*w + p] / double(num_perf_this_well);
+                            perf_rates[np*perf + p] = rates[p] / double(num_perf_this_well);
                         }
-                        perfPress()[perf] = cellPressures[wells->well_cells[perf]];
+                        const int perf_idx = wells->well_connpos[w] + perf;
+                        perfPress()[perf_idx] = cellPressures[wells->well_cells[perf_idx]];
                     }
                 }
             }
@@ -392,10 +431,8 @@ namespace Opm
                         thp()[ newIndex ] = prevState.thp()[ oldIndex ];
 
                         // wellrates
-                        for( int i=0, idx=newIndex*np, oldidx=oldIndex*np; i<np; ++i, ++idx, ++oldidx )
-                        {
-                            wellRates()[ idx ] = prevState.wellRates()[ oldidx ];
-                        }
+                        const auto old_rates = prevState.wellRates( oldIndex );
+                        std::copy( old_rates.begin(), old_rates.end(), wellRates( newIndex ).begin() );
 
                         // perfPhaseRates
                         const int oldPerf_idx_beg = (*it).second[ 1 ];
@@ -412,9 +449,11 @@ namespace Opm
                                 perfPhaseRates()[ perf_phase_idx ] = prevState.perfPhaseRates()[ old_perf_phase_idx ];
                             }
                         } else {
-                            for (int perf = wells->well_connpos[newIndex]; perf < wells->well_connpos[newIndex + 1]; ++perf) {
+                            const auto rates = wellRates(newIndex);
+                            auto perf_rates = perfPhaseRates(newIndex);
+                            for (int perf = 0; perf < num_perf_this_well; ++perf) {
                                 for (int p = 0; p < np; ++p) {
-                                    perfPhaseRates()[np*perf + p] = wellRates()[np*newIndex + p] / double(num_perf_this_well);
+                                    perf_rates[np*perf + p] = rates[p] / double(num_perf_this_well);
                                 }
                             }
                         }
@@ -494,6 +533,18 @@ namespace Opm
         std::vector<double>& perfPhaseRates() { return perfphaserates_; }
         const std::vector<double>& perfPhaseRates() const { return perfphaserates_; }
 
+        /// The rates of well w, one per phase.
+        WellRecord<double> wellRates(const int w) { return perWellRecord_(wellRates(), w); }
+        WellRecord<const double> wellRates(const int w) const { return perWellRecord_(wellRates(), w); }
+
+        /// The connection rates of well w, one per phase and connection of the well.
+        WellRecord<double> perfPhaseRates(const int w) { return perPerfRecord_(perfphaserates_, w, numPhases()); }
+        WellRecord<const double> perfPhaseRates(const int w) const { return perPerfRecord_(perfphaserates_, w, numPhases()); }
+
+        /// The pressures of the connections of well w.
+        WellRecord<double> perfPress(const int w) { return perPerfRecord_(perfPress(), w, 1); }
+        WellRecord<const double> perfPress(const int w) const { return perPerfRecord_(perfPress(), w, 1); }
+
         /// One current control per well.
         std::vector<int>& currentControls() { return current_controls_; }
         const std::vector<int>& currentControls() const { return current_controls_; }
@@ -648,10 +699,8 @@ namespace Opm
                     nseg_ += 1;
                     seg_number_.push_back(1); // Assign single segment (top) as number 1.
                     segpress_.push_back(bhp()[w]);
-                    const int np = numPhases();
-                    for (int p = 0; p < np; ++p) {
-                        segrates_.push_back(wellRates()[np * w + p]);
-                    }
+                    const auto rates = wellRates(w);
+                    segrates_.insert(segrates_.end(), rates.begin(), rates.end());
                 } else { // it is a multi-segment well
                     const WellSegments& segment_set = well_ecl.getSegments();
                     // assuming the order of the perforations in well_ecl is the same with Wells
@@ -821,13 +870,14 @@ namespace Opm
         std::vector<double>& perfRateSolvent() { return perfRateSolvent_; }
         const std::vector<double>& perfRateSolvent() const { return perfRateSolvent_; }
 
+        /// The solvent rates of the connections of well w.
+        WellRecord<double> perfRateSolvent(const int w) { return perPerfRecord_(perfRateSolvent_, w, 1); }
+        WellRecord<const double> perfRateSolvent(const int w) const { return perPerfRecord_(perfRateSolvent_, w, 1); }
+
         /// One rate pr well
         double solventWellRate(const int w) const {
-            double solvent_well_rate = 0.0;
-            for (int perf = wells_->well_connpos[w]; perf < wells_->well_connpos[w+1]; ++perf ) {
-                solvent_well_rate += perfRateSolvent_[perf];
-            }
-            return solvent_well_rate;
+            const auto rates = perfRateSolvent(w);
+            return std::accumulate(rates.begin(), rates.end(), 0.0);
         }
 
         std::vector<double>& wellReservoirRates()
@@ -835,6 +885,11 @@ namespace Opm
             return well_reservoir_rates_;
         }
 
+        WellRecord<double> wellReservoirRates(const int w)
+        {
+            return perWellRecord_(well_reservoir_rates_, w);
+        }
+
         std::vector<double>& wellDissolvedGasRates()
         {
             return well_dissolved_gas_rates_;
@@ -885,6 +940,14 @@ namespace Opm
             return productivity_index_;
         }
 
+        WellRecord<double> productivityIndex(const int w) {
+            return perWellRecord_(productivity_index_, w);
+        }
+
+        WellRecord<const double> productivityIndex(const int w) const {
+            return perWellRecord_(productivity_index_, w);
+        }
+
         std::vector<double>& wellPotentials() {
             return well_potentials_;
         }
@@ -893,6 +956,14 @@ namespace Opm
             return well_potentials_;
         }
 
+        WellRecord<double> wellPotentials(const int w) {
+            return perWellRecord_(well_potentials_, w);
+        }
+
+        WellRecord<const double> wellPotentials(const int w) const {
+            return perWellRecord_(well_potentials_, w);
+        }
+
         std::vector<double>& perfThroughput() {
             return perf_water_throughput_;
         }
@@ -901,6 +972,14 @@ namespace Opm
             return perf_water_throughput_;
         }
 
+        WellRecord<double> perfThroughput(const int w) {
+            return perPerfRecord_(perf_water_throughput_, w, 1);
+        }
+
+        WellRecord<const double> perfThroughput(const int w) const {
+            return perPerfRecord_(perf_water_throughput_, w, 1);
+        }
+
         std::vector<double>& perfSkinPressure() {
             return perf_skin_pressure_;
         }
@@ -909,6 +988,14 @@ namespace Opm
             return perf_skin_pressure_;
         }
 
+        WellRecord<double> perfSkinPressure(const int w) {
+            return perPerfRecord_(perf_skin_pressure_, w, 1);
+        }
+
+        WellRecord<const double> perfSkinPressure(const int w) const {
+            return perPerfRecord_(perf_skin_pressure_, w, 1);
+        }
+
         std::vector<double>& perfWaterVelocity() {
             return perf_water_velocity_;
         }
@@ -917,6 +1004,70 @@ namespace Opm
             return perf_water_velocity_;
         }
 
+        WellRecord<double> perfWaterVelocity(const int w) {
+            return perPerfRecord_(perf_water_velocity_, w, 1);
+        }
+
+        WellRecord<const double> perfWaterVelocity(const int w) const {
+            return perPerfRecord_(perf_water_velocity_, w, 1);
+        }
+
+        /// Write the values of the state to a checkpoint or read them from
+        /// it, see WellState::checkpoint().
+        template <class Serializer>
+        void checkpoint(Serializer& serializer)
+        {
+            BaseType::checkpoint(serializer);
+            serializer.vector("wells/perfphaserates", perfphaserates_);
+            serializer.vector("wells/current_controls", current_controls_);
+            serializer.vector("wells/perfRateSolvent", perfRateSolvent_);
+            serializer.vector("wells/perf_water_throughput", perf_water_throughput_);
+            serializer.vector("wells/perf_skin_pressure", perf_skin_pressure_);
+            serializer.vector("wells/perf_water_velocity", perf_water_velocity_);
+            serializer.vector("wells/well_reservoir_rates", well_reservoir_rates_);
+            serializer.vector("wells/well_dissolved_gas_rates", well_dissolved_gas_rates_);
+            serializer.vector("wells/well_vaporized_oil_rates", well_vaporized_oil_rates_);
+            serializer.vector("wells/effective_events_occurred", effective_events_occurred_);
+            serializer.vector("wells/segrates", segrates_);
+            serializer.vector("wells/segpress", segpress_);
+            serializer.vector("wells/top_segment_index", top_segment_index_);
+            serializer.value("wells/nseg", nseg_);
+            serializer.vector("wells/productivity_index", productivity_index_);
+            serializer.vector("wells/well_potentials", well_potentials_);
+            serializer.vector("wells/seg_number", seg_number_);
+        }
+
+        /// Copy the values of another state of the same set of wells
+        /// without allocating memory, see WellState::copyValuesFrom().
+        /// This is used to save and restore the well state around time
+        /// steps which may fail.
+        void copyValuesFrom(const WellStateFullyImplicitBlackoil& rhs)
+        {
+            if (!this->hasSameWells(rhs)) {
+                *this = rhs;
+                return;
+            }
+
+            BaseType::copyValuesFrom(rhs);
+            perfphaserates_ = rhs.perfphaserates_;
+            current_controls_ = rhs.current_controls_;
+            perfRateSolvent_ = rhs.perfRateSolvent_;
+            perf_water_throughput_ = rhs.perf_water_throughput_;
+            perf_skin_pressure_ = rhs.perf_skin_pressure_;
+            perf_water_velocity_ = rhs.perf_water_velocity_;
+            well_reservoir_rates_ = rhs.well_reservoir_rates_;
+            well_dissolved_gas_rates_ = rhs.well_dissolved_gas_rates_;
+            well_vaporized_oil_rates_ = rhs.well_vaporized_oil_rates_;
+            effective_events_occurred_ = rhs.effective_events_occurred_;
+            segrates_ = rhs.segrates_;
+            segpress_ = rhs.segpress_;
+            top_segment_index_ = rhs.top_segment_index_;
+            nseg_ = rhs.nseg_;
+            productivity_index_ = rhs.productivity_index_;
+            well_potentials_ = rhs.well_potentials_;
+            seg_number_ = rhs.seg_number_;
+        }
+
     private:
         std::vector<double> perfphaserates_;
         std::vector<int> current_controls_;
@@ -1027,6 +1178,27 @@ namespace Opm
 
             return this->seg_number_[top_offset + seg_id];
         }
+
+        /// Record of well w in an array holding one value per phase and well.
+        template <class Vector>
+        auto perWellRecord_(Vector& values, const int w) const
+            -> WellRecord<typename std::remove_reference<decltype(values[0])>::type>
+        {
+            const int np = this->numPhases();
+            assert(int(values.size()) >= np * (w + 1));
+            return { values.data() + np * w, np };
+        }
+
+        /// Record of well w in an array holding num_values values per connection.
+        template <class Vector>
+        auto perPerfRecord_(Vector& values, const int w, const int num_values) const
+            -> WellRecord<typename std::remove_reference<decltype(values[0])>::type>
+        {
+            const int begin = this->wells_->well_connpos[w];
+            const int end = this->wells_->well_connpos[w + 1];
+            assert(int(values.size()) >= num_values * end);
+            return { values.data() + num_values * begin, num_values * (end - begin) };
+        }
     };
 
 } // namespace Opm
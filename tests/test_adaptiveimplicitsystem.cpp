@@ -0,0 +1,171 @@
+/*
+  Copyright 2019 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+#define BOOST_TEST_MODULE AdaptiveImplicitSystemTest
+#include <boost/test/unit_test.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+
+#include <opm/simulators/linalg/AdaptiveImplicitSystem.hpp>
+
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/dynvector.hh>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+
+#include <vector>
+
+namespace {
+
+    typedef Dune::FieldMatrix<double, 2, 2> Block;
+    typedef Dune::BCRSMatrix<Block> Matrix;
+    typedef Dune::BlockVector<Dune::FieldVector<double, 2>> Vector;
+
+    // the first primary variable is the pressure, the second one a saturation
+    const int pressureIdx = 0;
+
+    Block block(double a00, double a01, double a10, double a11)
+    {
+        Block b;
+        b[0][0] = a00; b[0][1] = a01;
+        b[1][0] = a10; b[1][1] = a11;
+        return b;
+    }
+
+    // three cells in a row. the fluxes of the neighbors of the middle cell do not
+    // depend on its saturation, so treating it explicitly does not change the update.
+    Matrix threeCellSystem()
+    {
+        Matrix matrix(3, 3, 7, Matrix::row_wise);
+        for (auto row = matrix.createbegin(); row != matrix.createend(); ++row) {
+            const unsigned cellIdx = row.index();
+            if (cellIdx > 0)
+                row.insert(cellIdx - 1);
+            row.insert(cellIdx);
+            if (cellIdx < 2)
+                row.insert(cellIdx + 1);
+        }
+
+        matrix[0][0] = block(4.0, 1.0, 0.5, 3.0);
+        matrix[0][1] = block(-1.0, 0.0, -0.2, 0.0);
+        matrix[1][0] = block(-1.0, -0.3, -0.1, -0.4);
+        matrix[1][1] = block(5.0, 0.7, 0.4, 2.0);
+        matrix[1][2] = block(-1.5, -0.2, -0.3, -0.6);
+        matrix[2][1] = block(-0.8, 0.0, -0.1, 0.0);
+        matrix[2][2] = block(3.0, 0.2, 0.6, 2.5);
+        return matrix;
+    }
+
+    Vector threeCellRhs()
+    {
+        Vector rhs(3);
+        rhs[0][0] = 1.0; rhs[0][1] = -0.5;
+        rhs[1][0] = 0.3; rhs[1][1] = 0.8;
+        rhs[2][0] = -1.2; rhs[2][1] = 0.1;
+        return rhs;
+    }
+
+    // solve the linear system directly
+    Vector solve(const Matrix& matrix, const Vector& rhs)
+    {
+        const int n = 2*matrix.N();
+        Dune::DynamicMatrix<double> denseMatrix(n, n, 0.0);
+        Dune::DynamicVector<double> denseRhs(n, 0.0);
+        for (auto row = matrix.begin(); row != matrix.end(); ++row) {
+            for (auto col = row->begin(); col != row->end(); ++col) {
+                for (int i = 0; i < 2; ++i) {
+                    for (int j = 0; j < 2; ++j) {
+                        denseMatrix[2*row.index() + i][2*col.index() + j] = (*col)[i][j];
+                    }
+                }
+            }
+            for (int i = 0; i < 2; ++i) {
+                denseRhs[2*row.index() + i] = rhs[row.index()][i];
+            }
+        }
+
+        Dune::DynamicVector<double> denseX(n, 0.0);
+        denseMatrix.solve(denseX, denseRhs);
+
+        Vector x(matrix.N());
+        for (unsigned cellIdx = 0; cellIdx < matrix.N(); ++cellIdx) {
+            for (int i = 0; i < 2; ++i) {
+                x[cellIdx][i] = denseX[2*cellIdx + i];
+            }
+        }
+        return x;
+    }
+
+    void checkClose(const Vector& x, const Vector& expected)
+    {
+        BOOST_REQUIRE_EQUAL(x.size(), expected.size());
+        for (unsigned cellIdx = 0; cellIdx < x.size(); ++cellIdx) {
+            for (int i = 0; i < 2; ++i) {
+                BOOST_CHECK_CLOSE(x[cellIdx][i], expected[cellIdx][i], 1e-10);
+            }
+        }
+    }
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(AllCellsImplicit)
+{
+    const Matrix original = threeCellSystem();
+    const Vector originalRhs = threeCellRhs();
+    const Vector expected = solve(original, originalRhs);
+
+    Matrix matrix = original;
+    Vector rhs = originalRhs;
+    Opm::AdaptiveImplicitSystem<Matrix, Vector> system;
+    BOOST_CHECK(!system.reduce(matrix, rhs, std::vector<bool>(3, false), pressureIdx));
+
+    Vector x = solve(matrix, rhs);
+    system.recover(x);
+    checkClose(x, expected);
+
+    system.restoreRhs(rhs);
+    checkClose(rhs, originalRhs);
+}
+
+BOOST_AUTO_TEST_CASE(ExplicitCell)
+{
+    const Matrix original = threeCellSystem();
+    const Vector originalRhs = threeCellRhs();
+    const Vector expected = solve(original, originalRhs);
+
+    Matrix matrix = original;
+    Vector rhs = originalRhs;
+    Opm::AdaptiveImplicitSystem<Matrix, Vector> system;
+    BOOST_CHECK(system.reduce(matrix, rhs, { false, true, false }, pressureIdx));
+
+    // the saturation of the explicit cell is decoupled from the system
+    BOOST_CHECK_EQUAL(matrix[1][1][1][1], 1.0);
+    BOOST_CHECK_EQUAL(matrix[1][1][1][0], 0.0);
+    BOOST_CHECK_EQUAL(matrix[1][0][1][0], 0.0);
+    BOOST_CHECK_EQUAL(rhs[1][1], 0.0);
+
+    Vector x = solve(matrix, rhs);
+    system.recover(x);
+    checkClose(x, expected);
+
+    system.restoreRhs(rhs);
+    checkClose(rhs, originalRhs);
+}
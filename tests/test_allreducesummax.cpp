@@ -0,0 +1,89 @@
+/*
+  Copyright 2019 Equinor.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE TestAllReduceSumMax
+#define BOOST_TEST_NO_MAIN
+
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/utils/allReduceSumMax.hpp>
+#include <dune/common/parallel/mpihelper.hh>
+
+#if HAVE_MPI
+struct MPIError
+{
+    MPIError(std::string s, int e) : errorstring(std::move(s)), errorcode(e){}
+    std::string errorstring;
+    int errorcode;
+};
+
+void MPI_err_handler(MPI_Comm*, int* err_code, ...)
+{
+    std::vector<char> err_string(MPI_MAX_ERROR_STRING);
+    int err_length;
+    MPI_Error_string(*err_code, err_string.data(), &err_length);
+    std::string s(err_string.data(), err_length);
+    std::cerr << "An MPI Error ocurred:" << std::endl << s << std::endl;
+    throw MPIError(s, *err_code);
+}
+#endif
+
+bool
+init_unit_test_func()
+{
+    return true;
+}
+
+BOOST_AUTO_TEST_CASE(SumAndMax)
+{
+    auto cc = Dune::MPIHelper::getCollectiveCommunication();
+    const double rank = cc.rank();
+    const double size = cc.size();
+
+    std::vector<double> values = { 1.0, rank, rank, -rank };
+    Opm::allReduceSumMax(cc, values, 2);
+
+    BOOST_CHECK_EQUAL(values[0], size);
+    BOOST_CHECK_EQUAL(values[1], size*(size - 1)/2);
+    BOOST_CHECK_EQUAL(values[2], size - 1);
+    BOOST_CHECK_EQUAL(values[3], 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(OnlyMax)
+{
+    auto cc = Dune::MPIHelper::getCollectiveCommunication();
+    std::vector<double> values = { static_cast<double>(cc.rank()) };
+    Opm::allReduceSumMax(cc, values, 0);
+    BOOST_CHECK_EQUAL(values[0], cc.size() - 1);
+}
+
+int main(int argc, char** argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+#if HAVE_MPI
+    // register a throwing error handler to allow for
+    // debugging with "catch throw" in gdb
+    MPI_Errhandler handler;
+    MPI_Comm_create_errhandler(MPI_err_handler, &handler);
+    MPI_Comm_set_errhandler(MPI_COMM_WORLD, handler);
+#endif
+    return boost::unit_test::unit_test_main(&init_unit_test_func, argc, argv);
+}
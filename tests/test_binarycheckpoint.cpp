@@ -0,0 +1,135 @@
+/*
+  Copyright 2019 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+#define BOOST_TEST_MODULE BinaryCheckpointTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/utils/BinaryCheckpoint.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct State
+{
+    int step = 0;
+    double time = 0.0;
+    std::vector<double> pressure;
+    std::vector<int> controls;
+    std::vector<bool> events;
+    std::vector<double> history;
+
+    template <class Serializer>
+    void checkpoint(Serializer& serializer)
+    {
+        serializer.value("step", step);
+        serializer.value("time", time);
+        serializer.vector("pressure", pressure);
+        serializer.vector("controls", controls);
+        serializer.vector("events", events);
+        serializer.dynamicVector("history", history);
+    }
+};
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(WriteAndRead)
+{
+    const std::string fileName = "test_binarycheckpoint_1.chk";
+
+    State out;
+    out.step = 7;
+    out.time = 1.25e7;
+    out.pressure = { 2.0e7, 2.1e7, 1.9e7 };
+    out.controls = { -1, 3 };
+    out.events = { true, false, true, true, false };
+    out.history = { 0.5, 0.25 };
+    {
+        Opm::CheckpointWriter writer(fileName);
+        out.checkpoint(writer);
+        writer.commit();
+    }
+
+    State in;
+    in.pressure.resize(3);
+    in.controls.resize(2);
+    in.events.resize(5);
+    {
+        Opm::CheckpointReader reader(fileName);
+        BOOST_CHECK(reader.hasRecord("pressure"));
+        BOOST_CHECK(!reader.hasRecord("saturation"));
+        in.checkpoint(reader);
+    }
+
+    BOOST_CHECK_EQUAL(in.step, out.step);
+    BOOST_CHECK_EQUAL(in.time, out.time);
+    BOOST_CHECK(in.pressure == out.pressure);
+    BOOST_CHECK(in.controls == out.controls);
+    BOOST_CHECK(in.events == out.events);
+    BOOST_CHECK(in.history == out.history);
+
+    std::remove(fileName.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(Mismatch)
+{
+    const std::string fileName = "test_binarycheckpoint_2.chk";
+
+    {
+        std::vector<double> values(4, 1.0);
+        Opm::CheckpointWriter writer(fileName);
+        writer.vector("values", values);
+        writer.commit();
+    }
+
+    Opm::CheckpointReader reader(fileName);
+    std::vector<double> wrongSize(3);
+    BOOST_CHECK_THROW(reader.vector("values", wrongSize), std::runtime_error);
+    std::vector<int> wrongType(4);
+    BOOST_CHECK_THROW(reader.vector("values", wrongType), std::runtime_error);
+    BOOST_CHECK_THROW(reader.vector("missing", wrongSize), std::runtime_error);
+
+    std::remove(fileName.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(UncommittedAndInvalid)
+{
+    const std::string fileName = "test_binarycheckpoint_3.chk";
+
+    {
+        int value = 1;
+        Opm::CheckpointWriter writer(fileName);
+        writer.value("value", value);
+    }
+    // the checkpoint is only created on commit
+    BOOST_CHECK_THROW(Opm::CheckpointReader reader(fileName), std::runtime_error);
+
+    {
+        std::ofstream garbage(fileName);
+        garbage << "this is not a checkpoint file";
+    }
+    BOOST_CHECK_THROW(Opm::CheckpointReader reader(fileName), std::runtime_error);
+
+    std::remove(fileName.c_str());
+}
@@ -132,14 +132,17 @@ void test_summary()
     simulator->startNextEpisode(0.0, 1e30);
 
     simulator->setEpisodeIndex(0);
+    eclWriter->prepareOutput(substep);
     eclWriter->evalSummaryState(substep);
     eclWriter->writeOutput(substep);
 
     simulator->setEpisodeIndex(1);
+    eclWriter->prepareOutput(substep);
     eclWriter->evalSummaryState(substep);
     eclWriter->writeOutput(substep);
 
     simulator->setEpisodeIndex(2);
+    eclWriter->prepareOutput(substep);
     eclWriter->evalSummaryState(substep);
     eclWriter->writeOutput(substep);
 
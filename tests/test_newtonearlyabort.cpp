@@ -0,0 +1,105 @@
+/*
+  Copyright 2019 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+#define BOOST_TEST_MODULE NewtonEarlyAbortTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/timestepping/NewtonEarlyAbort.hpp>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+    // the residual norms of the iterations, one entry per phase
+    using History = std::vector<std::vector<double>>;
+
+    const double growthFactor = 2.0;
+    const int stagnationIter = 3;
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(Diverging)
+{
+    // the largest norm grows by more than a factor of two in each of the last two
+    // iterations, although the other phase converges
+    const History history = {
+        { 1.0, 0.5 },
+        { 0.8, 0.1 },
+        { 2.0, 0.01 },
+        { 5.0, 0.001 },
+    };
+
+    std::string reason;
+    BOOST_CHECK(Opm::detectNewtonDivergence(history, growthFactor, stagnationIter, reason));
+    BOOST_CHECK(reason.find("grew") != std::string::npos);
+
+    // growing by less than the factor does not abort
+    const History slowGrowth = { { 1.0 }, { 1.5 }, { 2.0 } };
+    reason.clear();
+    BOOST_CHECK(!Opm::detectNewtonDivergence(slowGrowth, growthFactor, /*stagnationIter=*/0, reason));
+    BOOST_CHECK(reason.empty());
+
+    // a growth factor of one disables the check
+    BOOST_CHECK(!Opm::detectNewtonDivergence(history, /*growthFactor=*/1.0, /*stagnationIter=*/0, reason));
+}
+
+BOOST_AUTO_TEST_CASE(Stagnating)
+{
+    // the residual oscillates, but is not reduced within three iterations
+    const History history = {
+        { 1.0 },
+        { 0.5 },
+        { 0.9 },
+        { 0.6 },
+        { 1.0 },
+    };
+
+    std::string reason;
+    BOOST_CHECK(Opm::detectNewtonDivergence(history, growthFactor, stagnationIter, reason));
+    BOOST_CHECK(reason.find("not reduced") != std::string::npos);
+
+    // not enough iterations for the stagnation window
+    const History shortHistory(history.begin(), history.begin() + stagnationIter);
+    reason.clear();
+    BOOST_CHECK(!Opm::detectNewtonDivergence(shortHistory, growthFactor, stagnationIter, reason));
+
+    // a window of zero iterations disables the check
+    BOOST_CHECK(!Opm::detectNewtonDivergence(history, growthFactor, /*stagnationIter=*/0, reason));
+}
+
+BOOST_AUTO_TEST_CASE(Converging)
+{
+    const History history = {
+        { 1.0, 2.0 },
+        { 0.5, 0.7 },
+        { 0.1, 0.3 },
+        { 0.01, 0.02 },
+        { 1e-4, 1e-3 },
+        { 1e-6, 1e-7 },
+    };
+
+    std::string reason;
+    for (std::size_t numIter = 0; numIter <= history.size(); ++numIter) {
+        const History partialHistory(history.begin(), history.begin() + numIter);
+        BOOST_CHECK(!Opm::detectNewtonDivergence(partialHistory, growthFactor, stagnationIter, reason));
+    }
+    BOOST_CHECK(reason.empty());
+}
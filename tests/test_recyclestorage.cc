@@ -0,0 +1,123 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+#include "config.h"
+
+#include <ebos/eclproblem.hh>
+#include <ewoms/common/start.hh>
+
+#if HAVE_DUNE_FEM
+#include <dune/fem/misc/mpimanager.hh>
+#else
+#include <dune/common/parallel/mpihelper.hh>
+#endif
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#define CHECK(value, expected)             \
+    {                                      \
+        if ((value) != (expected))         \
+            std::abort();                  \
+    }
+
+BEGIN_PROPERTIES
+
+NEW_TYPE_TAG(TestRecycleStorageTypeTag, INHERITS_FROM(BlackOilModel, EclBaseProblem));
+
+END_PROPERTIES
+
+template <class TypeTag>
+std::unique_ptr<typename GET_PROP_TYPE(TypeTag, Simulator)>
+initSimulator(const char *filename)
+{
+    typedef typename GET_PROP_TYPE(TypeTag, Simulator) Simulator;
+
+    std::string filenameArg = "--ecl-deck-file-name=";
+    filenameArg += filename;
+
+    const char* argv[] = {
+        "test_recyclestorage",
+        filenameArg.c_str()
+    };
+
+    Ewoms::setupParameters_<TypeTag>(/*argc=*/sizeof(argv)/sizeof(argv[0]), argv, /*registerParams=*/false);
+
+    return std::unique_ptr<Simulator>(new Simulator);
+}
+
+// start a report step of the deck (each of them is one day long) and its first time
+// step. the well model is only set up by beginEpisode(), so it must be called before
+// beginTimeStep().
+template <class Simulator>
+void beginTimeStep(Simulator& simulator, int episodeIdx)
+{
+    const double day = 24*60*60;
+    simulator.startNextEpisode(/*episodeStartTime=*/episodeIdx*day, /*episodeLength=*/day);
+    simulator.setEpisodeIndex(episodeIdx);
+    simulator.problem().beginEpisode();
+
+    simulator.setTimeStepSize(day);
+    simulator.problem().beginTimeStep();
+}
+
+// the storage term of the first iteration may only be recycled if the limits which
+// DRSDT imposes on the dissolution factors are the same for both time levels.
+void test_DrsdtRecycling();
+void test_DrsdtRecycling()
+{
+    typedef TTAG(TestRecycleStorageTypeTag) TypeTag;
+    auto simulator = initSimulator<TypeTag>("drsdt.DATA");
+    auto& problem = simulator->problem();
+
+    simulator->model().applyInitialSolution();
+
+    // 'DRSDT 0': the dissolution factors may not grow in any cell
+    beginTimeStep(*simulator, /*episodeIdx=*/0);
+    CHECK(problem.recycleFirstIterationStorage(), true);
+
+    // 'DRSDT 0 FREE': the dissolution factors of cells without free gas are not limited
+    beginTimeStep(*simulator, /*episodeIdx=*/1);
+    CHECK(problem.recycleFirstIterationStorage(), false);
+
+    // 'DRSDT 1e-4': the dissolution factors may grow during the time step
+    beginTimeStep(*simulator, /*episodeIdx=*/2);
+    CHECK(problem.recycleFirstIterationStorage(), false);
+}
+
+int main(int argc, char** argv)
+{
+#if HAVE_DUNE_FEM
+    Dune::Fem::MPIManager::initialize(argc, argv);
+#else
+    Dune::MPIHelper::instance(argc, argv);
+#endif
+
+    typedef TTAG(TestRecycleStorageTypeTag) TypeTag;
+    Ewoms::registerAllParameters_<TypeTag>();
+
+    test_DrsdtRecycling();
+
+    return 0;
+}
@@ -0,0 +1,121 @@
+/*
+  Copyright 2019 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+#define BOOST_TEST_MODULE RestartSegmentsTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/utils/RestartSegments.hpp>
+
+#include <opm/output/data/Cells.hpp>
+#include <opm/parser/eclipse/Units/UnitSystem.hpp>
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+Opm::data::Solution segmentData(const std::vector<double>& pressure,
+                                const std::vector<double>& swat)
+{
+    Opm::data::Solution sol;
+    sol.insert("PRESSURE", Opm::UnitSystem::measure::pressure, pressure, Opm::data::TargetType::RESTART_SOLUTION);
+    sol.insert("SWAT", Opm::UnitSystem::measure::identity, swat, Opm::data::TargetType::RESTART_SOLUTION);
+    return sol;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(WriteAndStitch)
+{
+    const std::string dir = ".";
+    const std::string base = "TEST_RESTARTSEGMENTS";
+    const int reportStep = 3;
+    const int numCells = 5;
+
+    // two segments which each contain the interior cells of one process
+    const std::vector<int> globalIndex0 = { 0, 2, 1 };
+    const std::vector<int> globalIndex1 = { 4, 3 };
+    Opm::writeRestartSegment(Opm::restartSegmentFileName(dir, base, reportStep, 0),
+                             reportStep, 0, 2, numCells, globalIndex0,
+                             segmentData({ 100.0, 102.0, 101.0 }, { 0.1, 0.3, 0.2 }));
+    Opm::writeRestartSegment(Opm::restartSegmentFileName(dir, base, reportStep, 1),
+                             reportStep, 1, 2, numCells, globalIndex1,
+                             segmentData({ 104.0, 103.0 }, { 0.5, 0.4 }));
+
+    const auto sol = Opm::stitchRestartSegments(dir, base, reportStep);
+    BOOST_CHECK_EQUAL(sol.size(), 2U);
+    BOOST_CHECK(sol.has("PRESSURE"));
+    BOOST_CHECK(sol.has("SWAT"));
+    BOOST_CHECK(sol.at("PRESSURE").dim == Opm::UnitSystem::measure::pressure);
+
+    const std::vector<double> expectedPressure = { 100.0, 101.0, 102.0, 103.0, 104.0 };
+    const std::vector<double> expectedSwat = { 0.1, 0.2, 0.3, 0.4, 0.5 };
+    BOOST_CHECK(sol.data("PRESSURE") == expectedPressure);
+    BOOST_CHECK(sol.data("SWAT") == expectedSwat);
+
+    // a segment is missing
+    BOOST_CHECK_THROW(Opm::stitchRestartSegments(dir, base, reportStep + 1), std::runtime_error);
+
+    std::remove(Opm::restartSegmentFileName(dir, base, reportStep, 0).c_str());
+    std::remove(Opm::restartSegmentFileName(dir, base, reportStep, 1).c_str());
+}
+
+BOOST_AUTO_TEST_CASE(InconsistentSegments)
+{
+    const std::string dir = ".";
+    const std::string base = "TEST_RESTARTSEGMENTS_2";
+    const std::vector<int> globalIndex = { 0, 1 };
+
+    // the data does not match the cells of the segment
+    BOOST_CHECK_THROW(Opm::writeRestartSegment(Opm::restartSegmentFileName(dir, base, 1, 0),
+                                               1, 0, 1, 2, globalIndex,
+                                               segmentData({ 1.0 }, { 0.5 })),
+                      std::logic_error);
+
+    // cell index outside of the grid
+    Opm::writeRestartSegment(Opm::restartSegmentFileName(dir, base, 1, 0),
+                             1, 0, 1, 1, globalIndex,
+                             segmentData({ 1.0, 2.0 }, { 0.5, 0.6 }));
+    BOOST_CHECK_THROW(Opm::stitchRestartSegments(dir, base, 1), std::runtime_error);
+
+    std::remove(Opm::restartSegmentFileName(dir, base, 1, 0).c_str());
+
+    // cell 1 is part of both segments and cell 2 of none
+    const std::vector<int> globalIndex1 = { 1, 3 };
+    Opm::writeRestartSegment(Opm::restartSegmentFileName(dir, base, 2, 0),
+                             2, 0, 2, 4, globalIndex,
+                             segmentData({ 1.0, 2.0 }, { 0.5, 0.6 }));
+    Opm::writeRestartSegment(Opm::restartSegmentFileName(dir, base, 2, 1),
+                             2, 1, 2, 4, globalIndex1,
+                             segmentData({ 2.0, 4.0 }, { 0.6, 0.8 }));
+    BOOST_CHECK_THROW(Opm::stitchRestartSegments(dir, base, 2), std::runtime_error);
+
+    // cell 2 is missing
+    const std::vector<int> globalIndex2 = { 3 };
+    Opm::writeRestartSegment(Opm::restartSegmentFileName(dir, base, 2, 1),
+                             2, 1, 2, 4, globalIndex2,
+                             segmentData({ 4.0 }, { 0.8 }));
+    BOOST_CHECK_THROW(Opm::stitchRestartSegments(dir, base, 2), std::runtime_error);
+
+    std::remove(Opm::restartSegmentFileName(dir, base, 2, 0).c_str());
+    std::remove(Opm::restartSegmentFileName(dir, base, 2, 1).c_str());
+}
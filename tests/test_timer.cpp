@@ -28,6 +28,7 @@
 #include <opm/parser/eclipse/Deck/Deck.hpp>
 #include <opm/parser/eclipse/Parser/Parser.hpp>
 #include <opm/simulators/timestepping/SimulatorTimer.hpp>
+#include <opm/simulators/timestepping/TimeStepControl.hpp>
 #include <opm/parser/eclipse/Units/Units.hpp>
 
 #include <string>
@@ -113,3 +114,52 @@ BOOST_AUTO_TEST_CASE(CreateTimer)
 
     
 }
+
+BOOST_AUTO_TEST_CASE(ConvergenceRateTimeStepControl)
+{
+    const double day = Opm::unit::day;
+    Opm::ConvergenceRateTimeStepControl control(/*target_iterations=*/8, /*tol=*/1e-1, /*history_size=*/2);
+
+    // nothing is known yet
+    BOOST_CHECK_EQUAL( 30*day, control.limitTimeStepSize(30*day) );
+
+    // a step which converged quickly does not limit the step size
+    control.recordConvergenceHistory(1*day, {100.0, 10.0, 1.0, 0.1}, /*converged=*/true);
+    BOOST_CHECK_EQUAL( 30*day, control.limitTimeStepSize(30*day) );
+
+    // the residuals were halved in each iteration: after eight iterations, the initial
+    // residual must not exceed 2^8, i.e., 2.56 times the one of this step
+    std::vector<double> residuals = {100.0};
+    for (int i = 0; i < 9; ++i) {
+        residuals.push_back(0.5*residuals.back());
+    }
+    control.recordConvergenceHistory(10*day, residuals, /*converged=*/true);
+    BOOST_CHECK_CLOSE( 25.6*day, control.limitTimeStepSize(30*day), 1e-8 );
+    BOOST_CHECK_EQUAL( 20*day, control.limitTimeStepSize(20*day) );
+
+    // a failed step size is not attempted again
+    control.recordConvergenceHistory(20*day, {100.0, 200.0, 400.0}, /*converged=*/false);
+    BOOST_CHECK_CLOSE( 15*day, control.limitTimeStepSize(20*day), 1e-8 );
+
+    // only the most recent steps are remembered
+    control.recordConvergenceHistory(1*day, {100.0, 10.0, 1.0, 0.1}, /*converged=*/true);
+    control.recordConvergenceHistory(1*day, {100.0, 10.0, 1.0, 0.1}, /*converged=*/true);
+    BOOST_CHECK_EQUAL( 30*day, control.limitTimeStepSize(30*day) );
+}
+
+BOOST_AUTO_TEST_CASE(TimeStepControlState)
+{
+    const double day = Opm::unit::day;
+    Opm::ConvergenceRateTimeStepControl control(/*target_iterations=*/8, /*tol=*/1e-1, /*history_size=*/5);
+    control.recordConvergenceHistory(20*day, {100.0, 200.0, 400.0}, /*converged=*/false);
+    BOOST_CHECK_CLOSE( 15*day, control.limitTimeStepSize(20*day), 1e-8 );
+
+    // a restored controller behaves like the original one
+    Opm::ConvergenceRateTimeStepControl restored(/*target_iterations=*/8, /*tol=*/1e-1, /*history_size=*/5);
+    BOOST_CHECK_EQUAL( 20*day, restored.limitTimeStepSize(20*day) );
+    restored.setState(control.state());
+    BOOST_CHECK_CLOSE( 15*day, restored.limitTimeStepSize(20*day), 1e-8 );
+    BOOST_CHECK( control.state() == restored.state() );
+
+    BOOST_CHECK_THROW( restored.setState({1.0, 2.0}), std::runtime_error );
+}
@@ -71,6 +71,10 @@ BOOST_AUTO_TEST_CASE(AddWellsAndGroupToCollection) {
     BOOST_CHECK_EQUAL("G1", collection.findNode("INJ2")->getParent()->name());
     BOOST_CHECK_EQUAL("G2", collection.findNode("PROD1")->getParent()->name());
     BOOST_CHECK_EQUAL("G2", collection.findNode("PROD2")->getParent()->name());
+
+    BOOST_CHECK(collection.findNode("NOTANODE") == nullptr);
+    BOOST_CHECK_EQUAL("PROD1", collection.findWellNode("PROD1").name());
+    BOOST_CHECK_THROW(collection.findWellNode("G1"), std::runtime_error);
 }
 
 BOOST_AUTO_TEST_CASE(EfficiencyFactor) {
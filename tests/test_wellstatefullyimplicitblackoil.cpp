@@ -302,4 +302,44 @@ BOOST_AUTO_TEST_CASE(Rates)
     }
 }
 
+// ---------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(CopyValues)
+{
+    const Setup setup{ "msw.data" };
+    const auto tstep = std::size_t{0};
+
+    auto source = buildWellState(setup, tstep);
+    auto target = buildWellState(setup, tstep);
+
+    BOOST_CHECK(target.hasSameWells(source));
+
+    const auto& wells = setup.sched.getWells2(tstep);
+    setSegPress(wells, source);
+    source.bhp()[0] = 123.0*Opm::unit::barsa;
+
+    const auto* segPressData = target.segPress().data();
+    const auto* bhpData = target.bhp().data();
+
+    target.copyValuesFrom(source);
+
+    // the values are copied into the existing storage
+    BOOST_CHECK(target.segPress().data() == segPressData);
+    BOOST_CHECK(target.bhp().data() == bhpData);
+
+    BOOST_CHECK_CLOSE(target.bhp()[0], 123.0*Opm::unit::barsa, 1.0e-10);
+    BOOST_CHECK_EQUAL(target.segPress().size(), source.segPress().size());
+    for (std::size_t segIdx = 0; segIdx < source.segPress().size(); ++segIdx) {
+        BOOST_CHECK_CLOSE(target.segPress()[segIdx], source.segPress()[segIdx], 1.0e-10);
+    }
+
+    // states of different wells are assigned completely
+    auto empty = Opm::WellStateFullyImplicitBlackoil{};
+    BOOST_CHECK(!empty.hasSameWells(source));
+
+    empty.copyValuesFrom(source);
+    BOOST_CHECK(empty.hasSameWells(source));
+    BOOST_CHECK_EQUAL(empty.numWells(), source.numWells());
+}
+
 BOOST_AUTO_TEST_SUITE_END()